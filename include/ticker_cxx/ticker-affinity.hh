@@ -0,0 +1,256 @@
+// ticker_cxx Library
+// Copyright © 2021 Hedzr Yeh.
+//
+// This file is released under the terms of the MIT license.
+// Read /LICENSE for more information.
+
+//
+// Created by Hedzr Yeh on 2021/11/18.
+//
+
+#ifndef TICKER_CXX_TICKER_AFFINITY_HH
+#define TICKER_CXX_TICKER_AFFINITY_HH
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <dirent.h>
+#endif
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace ticker::pool {
+
+  /**
+     * @brief parses a CPU list of sysfs, such as "0-3,8,10-11".
+     * @return the CPUs ascending, empty if s is malformed
+     */
+  inline std::vector<int> parse_cpu_list(std::string const &s) {
+    std::vector<int> cpus;
+    std::size_t i = 0;
+    auto number = [&s, &i](int &v) {
+      std::size_t from = i;
+      v = 0;
+      while (i < s.size() && s[i] >= '0' && s[i] <= '9') v = v * 10 + (s[i++] - '0');
+      return i > from;
+    };
+    while (i < s.size() && s[i] != '\n') {
+      int lo, hi;
+      if (!number(lo)) return {};
+      hi = lo;
+      if (i < s.size() && s[i] == '-') {
+        ++i;
+        if (!number(hi) || hi < lo) return {};
+      }
+      for (int c = lo; c <= hi; ++c) cpus.push_back(c);
+      if (i < s.size() && s[i] == ',') ++i;
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return cpus;
+  }
+
+  /**
+     * @brief formats CPUs as a CPU list of sysfs, parse_cpu_list() reversed.
+     */
+  inline std::string format_cpu_list(std::vector<int> const &cpus) {
+    std::string s;
+    for (std::size_t i = 0; i < cpus.size();) {
+      std::size_t j = i;
+      while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) ++j;
+      if (!s.empty()) s += ',';
+      s += std::to_string(cpus[i]);
+      if (j > i) s += '-' + std::to_string(cpus[j]);
+      i = j + 1;
+    }
+    return s;
+  }
+
+  /**
+     * @brief the NUMA nodes and their CPUs.
+     */
+  struct cpu_topology {
+    std::vector<std::vector<int>> nodes{}; // the CPUs of each node having any, in the order of the node ids
+    std::vector<int> ids{};                // the kernel id of each of nodes, such as 0 and 2 without a CPU on node 1
+
+    /**
+         * @brief reads `node/node<N>/cpulist` under root; falls back to
+         * one node of `cpu/online`, or of std::thread::hardware_concurrency().
+         */
+    static cpu_topology detect(std::string const &root = "/sys/devices/system") {
+      std::vector<std::pair<int, std::vector<int>>> found;
+#if defined(__unix__) || defined(__APPLE__)
+      if (DIR *d = ::opendir((root + "/node").c_str())) {
+        while (dirent *entry = ::readdir(d)) {
+          std::string name = entry->d_name;
+          if (name.size() <= 4 || name.compare(0, 4, "node") != 0 ||
+              name.find_first_not_of("0123456789", 4) != std::string::npos)
+            continue;
+          auto cpus = parse_cpu_list(read_line(root + "/node/" + name + "/cpulist"));
+          if (cpus.empty()) continue; // a memory-only node
+          found.emplace_back(std::stoi(name.substr(4)), std::move(cpus));
+        }
+        ::closedir(d);
+      }
+#endif
+      std::sort(found.begin(), found.end(), [](auto const &a, auto const &b) { return a.first < b.first; });
+      cpu_topology t;
+      for (auto &n : found) {
+        t.ids.push_back(n.first);
+        t.nodes.emplace_back(std::move(n.second));
+      }
+      if (t.nodes.empty()) {
+        auto cpus = parse_cpu_list(read_line(root + "/cpu/online"));
+        if (cpus.empty())
+          for (unsigned c = 0; c < std::max(1u, std::thread::hardware_concurrency()); ++c) cpus.push_back(int(c));
+        t.ids.push_back(0);
+        t.nodes.emplace_back(std::move(cpus));
+      }
+      return t;
+    }
+
+    std::size_t cpu_count() const {
+      std::size_t n{};
+      for (auto const &cpus : nodes) n += cpus.size();
+      return n;
+    }
+    // the kernel id of the node of cpu, -1 if unknown
+    int node_of(int cpu) const {
+      for (std::size_t i = 0; i < nodes.size(); ++i)
+        if (std::binary_search(nodes[i].begin(), nodes[i].end(), cpu)) return id_at(i);
+      return -1;
+    }
+    // the CPUs of the node of kernel id, empty if it has none
+    std::vector<int> cpus_of(int id) const {
+      for (std::size_t i = 0; i < nodes.size(); ++i)
+        if (id_at(i) == id) return nodes[i];
+      return {};
+    }
+
+  private:
+    // ids may be left empty by a topology built by hand: dense ids then
+    int id_at(std::size_t i) const { return i < ids.size() ? ids[i] : int(i); }
+    static std::string read_line(std::string const &path) {
+      std::string s;
+      if (std::FILE *f = std::fopen(path.c_str(), "r")) {
+        for (int c; (c = std::fgetc(f)) != EOF && c != '\n';) s += char(c);
+        std::fclose(f);
+      }
+      return s;
+    }
+  };
+
+  /**
+     * @brief binds the calling thread to cpus.
+     * @return false if it's not supported (not Linux), or the kernel
+     * refused it, such as for the CPUs out of the cgroup of the process
+     */
+  inline bool pin_current_thread(std::vector<int> const &cpus) {
+#if defined(__linux__)
+    if (cpus.empty()) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c : cpus)
+      if (c >= 0 && c < CPU_SETSIZE) CPU_SET(c, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void) cpus;
+    return false;
+#endif
+  }
+
+  /**
+     * @brief where the runner of a scheduler and the workers of a
+     * thread_pool run.
+     * @details With a node, the runner and the workers stay on the CPUs
+     * of that node, so a scheduler per node keeps its jobs on the caches
+     * and the memory of the node. Without, worker i goes to node
+     * i % nodes, when spread_workers.
+     *
+     * The topology is read by resolve(), which the pool and the
+     * scheduler given a placement call before their threads start, so
+     * sysfs is not read for a placement never applied.
+     */
+  struct placement {
+    int runner_cpu{-1};                    // the CPU of the runner, -1 for the CPUs of node, or to leave it
+    int node{-1};                          // the kernel id of the NUMA node of the runner and the workers, -1 for all nodes
+    bool spread_workers{true};             // with no node: distributes the workers over the nodes
+    std::optional<cpu_topology> topology{}; // detected by resolve() if not given
+
+    // detects the topology if it's not given yet
+    cpu_topology const &resolve() {
+      if (!topology) topology = cpu_topology::detect();
+      return *topology;
+    }
+
+    // the CPUs of the runner, empty to leave it
+    std::vector<int> runner_cpus() const {
+      if (runner_cpu >= 0) return {runner_cpu};
+      if (node >= 0 && topology) return topology->cpus_of(node);
+      return {};
+    }
+    // the CPUs of the worker index, empty to leave it
+    std::vector<int> worker_cpus(std::size_t index) const {
+      if (!topology || topology->nodes.empty()) return {};
+      if (node >= 0) return topology->cpus_of(node);
+      if (spread_workers) return topology->nodes[index % topology->nodes.size()];
+      return {};
+    }
+  };
+
+  /**
+     * @brief the placements applied to the threads, for the logs.
+     */
+  class placement_report {
+  public:
+    struct entry {
+      std::string thread; // "runner", "worker 3"
+      std::vector<int> cpus;
+      int node;     // the kernel id of the node of the first CPU, -1 if unknown
+      bool applied; // false if pin_current_thread() failed
+    };
+
+    void add(std::string thread, std::vector<int> cpus, int node, bool applied) {
+      std::lock_guard<std::mutex> l(_m);
+      _entries.push_back(entry{std::move(thread), std::move(cpus), node, applied});
+    }
+    std::vector<entry> entries() const {
+      std::lock_guard<std::mutex> l(_m);
+      return _entries;
+    }
+    // one line per thread: "worker 0: node 0, cpus 0-3"
+    std::string to_string() const {
+      std::string s;
+      for (auto const &e : entries()) {
+        s += e.thread + ": node " + std::to_string(e.node) + ", cpus " + format_cpu_list(e.cpus);
+        s += e.applied ? "\n" : " (not applied)\n";
+      }
+      return s;
+    }
+
+  private:
+    mutable std::mutex _m{};
+    std::vector<entry> _entries{};
+  };
+
+  // pins the calling thread to cpus and records it, if cpus is not empty
+  inline void apply_placement(placement_report &r, std::string thread, std::vector<int> cpus, placement const &where) {
+    if (cpus.empty()) return;
+    bool ok = pin_current_thread(cpus);
+    int node = where.topology ? where.topology->node_of(cpus.front()) : -1;
+    r.add(std::move(thread), std::move(cpus), node, ok);
+  }
+
+} // namespace ticker::pool
+
+#endif //TICKER_CXX_TICKER_AFFINITY_HH
@@ -15,6 +15,7 @@
 #include <functional>
 #include <string>
 #include <tuple>
+#include <type_traits>
 
 #include <fstream>
 #include <iomanip>
@@ -596,10 +597,15 @@ namespace ticker::chrono {
 
     return os;
   }
+  // NOTE: the time points of the other clocks, such as std::chrono::steady_clock,
+  // are shown as the wall clock time relative to now.
   template<class _Clock, class _Duration = typename _Clock::duration>
   inline std::string format_time_point(std::chrono::time_point<_Clock, _Duration> const &time, const char *format = "%Y-%m-%d %H:%M:%S") {
     std::stringstream ss;
-    serialize_time_point(ss, time, format);
+    if constexpr (std::is_same_v<_Clock, std::chrono::system_clock>)
+      serialize_time_point(ss, time, format);
+    else
+      serialize_time_point(ss, std::chrono::system_clock::now() + std::chrono::duration_cast<std::chrono::system_clock::duration>(time - _Clock::now()), format);
     return ss.str();
   }
   inline std::string format_time_point(const char *format = "%Y-%m-%d %H:%M:%S") { return format_time_point(std::chrono::system_clock::now(), format); }
@@ -22,6 +22,12 @@
 
 #include "ticker-anchors.hh"
 #include "ticker-jobs.hh"
+#include "ticker-mpsc-inbox.hh"
+#include "ticker-scheduler.hh"
+#include "ticker-timer-handle.hh"
+#include "ticker-timer-queue.hh"
+#include "ticker-timerfd.hh"
+#include "ticker-wait-strategy.hh"
 
 #include <chrono>
 #include <ctime>
@@ -30,12 +36,15 @@
 #include <iostream>
 #include <map>
 #include <queue>         // for std::priority_queue
+#include <stdexcept>
 #include <string>        // for std::string
 #include <tuple>         // for std::tuple
 #include <unordered_map> // for std::unordered_map
+#include <utility>       // for std::exchange
 #include <vector>
 
 #include <algorithm>
+#include <atomic>
 #include <functional>
 
 namespace ticker {
@@ -51,6 +60,9 @@ namespace ticker {
     using _This = base<__D>;
     struct __W : public __D { // timer<Derived, Clock, GMT, ConcreteJob> {
       __W() = default;
+      template<typename Service>
+      explicit __W(std::shared_ptr<Service> s)
+          : __D(std::move(s)) {}
       ~__W() {}
     };
     /**
@@ -64,6 +76,18 @@ namespace ticker {
       // return std::move(w);
       return std::make_unique<__W>();
     }
+    /**
+         * @brief get a unique pointer to the instance of __D attached to
+         * a shared service, such as a ticker::scheduler or an executor
+         * @param s the service
+         * @param fn_after_constructed a lambda with prototype `[]{ ... }`
+         * @return std::unique_ptr&lt;__D>
+         */
+    template<typename Service>
+    static std::unique_ptr<__D> get(std::shared_ptr<Service> s, std::function<void()> &&fn_after_constructed = nullptr) {
+      util::defer<bool> defer_(fn_after_constructed);
+      return std::make_unique<__W>(std::move(s));
+    }
     // static std::shared_ptr<base> create(std::function<void()> &&fn_after_constructed = nullptr) {
     //     util::defer<bool> defer_(fn_after_constructed);
     //     return std::make_shared<__W>();
@@ -84,62 +108,88 @@ namespace ticker {
   /**
      * @brief timer provides the standard Timer interface.
      * @tparam Clock 
+     * @tparam ConcreteJob the job built, wrap it in ticker::static_job&lt;>
+     * for the static dispatch.
+     * @tparam QueuePolicy the storage of pending jobs, such as
+     * ticker::queue::map_policy or ticker::queue::wheel_policy&lt;>.
+     * @tparam Waiter the runner thread sleeps on it, pool::timer_killer
+     * (a condition variable) by default, or pool::timerfd_waiter on Linux.
      * @details We assume a standard Timer interface will be represented as:
      * 
      * ### A
      *     - in/afetr
      *     - at
      * 
-     * 
+     * A timer is a front-end of a ticker::scheduler, which runs the
+     * jobs. `get()` makes a private one, `get(scheduler)` attaches to
+     * a shared one, and `get(executor)` makes a private one running
+     * the jobs on the executor.
      */
   template<typename DerivedT = std::nullopt_t,
            typename Clock = Clock,
            bool GMT = false,
-           typename ConcreteJob = detail::in_job<Clock, GMT>>
-  class timer_t : public base<typename std::conditional<std::is_same_v<std::nullopt_t, DerivedT>, timer_t<DerivedT, Clock, GMT, ConcreteJob>, DerivedT>::type> {
+           typename ConcreteJob = detail::in_job<Clock, GMT>,
+           typename QueuePolicy = queue::map_policy,
+           typename Waiter = pool::timer_killer>
+  class timer_t : public base<typename std::conditional<std::is_same_v<std::nullopt_t, DerivedT>, timer_t<DerivedT, Clock, GMT, ConcreteJob, QueuePolicy, Waiter>, DerivedT>::type> {
     // public:
     //     class posix_ticker {
     //     public:
     //     }; // class posix_ticker
 
   public:
-    using _This = timer_t<DerivedT, Clock, GMT, ConcreteJob>;
+    using _This = timer_t<DerivedT, Clock, GMT, ConcreteJob, QueuePolicy, Waiter>;
     using super = base<typename std::conditional<std::is_same_v<std::nullopt_t, DerivedT>, _This, DerivedT>::type>;
     using base_t = super;
-    using Job = timer_job;
-    using _J = std::shared_ptr<Job>;
+    // the job type built, ConcreteJob or the one wrapped by static_job<>
+    using concrete_job = typename detail::job_of<ConcreteJob>::type;
+    using scheduler_type = scheduler<Clock, QueuePolicy, Waiter,
+                                     std::conditional_t<detail::job_of<ConcreteJob>::is_static, concrete_job, basic_timer_job<Clock>>>;
+    using Job = typename scheduler_type::Job;
+    using _J = typename scheduler_type::_J;
     using _C = Clock;
-    using TP = std::chrono::time_point<_C>;
-    using Jobs = std::vector<_J>;
-    using TimingWheel = std::map<TP, Jobs>;
+    using TP = typename scheduler_type::TP;
+    using TimingWheel = typename scheduler_type::TimingWheel;
+    using PastJobs = typename scheduler_type::PastJobs;
 
   protected:
-    timer_t() : base_t{}, _pool(-1) { start(); }
+    timer_t()
+        : timer_t(std::make_shared<scheduler_type>()) {}
+    explicit timer_t(std::shared_ptr<scheduler_type> s)
+        : base_t{}
+        , _sched(std::move(s)) {}
+    // a private scheduler running the jobs on the executor e
+    template<typename Executor, typename = std::enable_if_t<pool::is_executor_v<Executor>>>
+    explicit timer_t(std::shared_ptr<Executor> e)
+        : timer_t(std::make_shared<scheduler_type>(std::move(e))) {}
     // CLAZZ_NON_MOVEABLE(timer);
     void __copy(timer_t const &o) {
       super::__copy(o);
       __COPY(_tp);
-      __COPY(_f);
-      // __COPY(_tk);
-      __COPY(_twl);
-      __COPY(_pasts);
-      // __COPY(_l_twl);
-      // __COPY(_pool);
-      // __COPY(_started);
-      // __COPY(_ended);
-      __COPY(_larger_gap);
-      __COPY(_wastage);
+      // __COPY(_f); // move-only
     }
 
   public:
-    timer_t(timer_t const &o) : base_t{}, _pool(-1) { __copy(o); }
-    timer_t(timer_t &&o) : base_t{}, _pool(-1) { __copy(o); }
+    // a copy shares the scheduler of o
+    timer_t(timer_t const &o)
+        : base_t{}
+        , _sched(o._sched) { __copy(o); }
+    timer_t(timer_t &&o)
+        : base_t{}
+        , _sched(o._sched) { __copy(o); }
     ~timer_t() override {
       dbg_debug("[timer] dtor...");
       clear();
     }
-    void clear() { stop(); }
-    void join() { stop(); }
+    void clear() { detach(); }
+    void join() { detach(); }
+    /**
+         * @brief cancel the pending jobs scheduled by this timer, the
+         * other front-ends of a shared scheduler are not affected.
+         * @return the count of the jobs cancelled
+         */
+    std::size_t detach() { return _sched->detach(_owner); }
+    std::shared_ptr<scheduler_type> const &get_scheduler() const { return _sched; }
 
     /**
          * @brief run task in (one minute, five seconds, ...)
@@ -180,212 +230,151 @@ namespace ticker {
       return in(tp);
     }
 
+    /**
+         * @brief keep the last n fired one-shot jobs of the scheduler
+         * for debugging, see scheduler::keep_history().
+         */
+    void keep_history(std::size_t n) { _sched->keep_history(n); }
+    /**
+         * @brief the fired one-shot jobs kept by keep_history(), the oldest first.
+         */
+    PastJobs history() const { return _sched->history(); }
+
+    /**
+         * @brief tolerate firing the job up to d late, so that it can
+         * share a wakeup with the jobs nearby.
+         * @details Like the Linux timer slack, the runner sleeps toward
+         * the earliest `due + slack` of the pending jobs, and a wakeup
+         * fires every slacked job whose window has opened.
+         */
+    typename super::__D &slack(std::chrono::nanoseconds d) {
+      _slack = d;
+      return static_cast<typename super::__D &>(*this);
+    }
+
     template<typename _Callable, typename... _Args>
     typename super::__D &on(_Callable &&f, _Args &&...args) {
-      _f = std::bind(std::forward<_Callable>(f), std::forward<_Args>(args)...);
+      if constexpr (sizeof...(_Args) == 0)
+        _f = std::forward<_Callable>(f); // no std::bind, a small lambda stays inline
+      else
+        _f = [f = std::forward<_Callable>(f), args = std::make_tuple(std::forward<_Args>(args)...)]() mutable { std::apply(f, args); };
       return static_cast<typename super::__D &>(*this);
     }
 
     // template<typename = std::enable_if_t<std::is_same<typename super::__D, _This>::value,int> =0>
-    void build() {
-      std::shared_ptr<Job> t = std::make_shared<ConcreteJob>(std::move(_f));
+    /**
+         * @brief schedule the job
+         * @details The callable given by on() moves into the job, so
+         * each build() needs its own on().
+         * @return a handle to cancel the job
+         * @throw std::logic_error if no on() precedes this build()
+         */
+    timer_handle build() {
+      std::shared_ptr<Job> t = make_job<concrete_job>(take_fn());
       // auto next_time = t->next_time_point();
       // dbg_debug("next_time: %s", format_time_point(next_time).c_str());
+      auto h = attach_job(*t);
       add_task(_tp, std::move(t));
+      return h;
     }
-
-  private:
-    void stop() {
-      dbg_debug("[runner] stopping...");
-      _t.detach();
-      _tk.kill();
-      // if (_t.joinable()) _t.join();
-      _ended.wait();
-      dbg_debug("[runner] stopped.");
+    /**
+         * @brief schedule f at tp, a thread-safe shortcut of `at(tp).slack(slack).on(f).build()`.
+         * @details The builder methods share the state of the timer, so
+         * the threads which schedule jobs concurrently should use this;
+         * the slack of slack() applies to build() only, pass it here.
+         */
+    timer_handle schedule(TP const &tp, job_fn &&f, std::chrono::nanoseconds slack = std::chrono::nanoseconds::zero()) {
+      std::shared_ptr<Job> t = make_job<concrete_job>(std::move(f));
+      t->slack(slack);
+      auto h = _sched->registry().attach(*t, &_owner);
+      add_task(tp, std::move(t));
+      return h;
     }
-    void start() {
-      {
-        std::unique_lock<std::mutex> l(_l_twl);
-        dbg_trace("[runner] starting...");
+    /**
+         * @brief schedule a batch of (time_point, callable) pairs at once.
+         * @details The jobs are made in one pass and attached to their
+         * handles under one lock, then sorted by time point and merged
+         * into the timer queue in a single critical section.
+         * @param slack of each job, as schedule() takes it
+         * @return the handles, in the order of the input
+         */
+    template<typename It>
+    std::vector<timer_handle> schedule_many(It first, It last, std::chrono::nanoseconds slack = std::chrono::nanoseconds::zero()) {
+      typename TimingWheel::items_t items;
+      for (; first != last; ++first) {
+        auto &&it = *first;
+        items.emplace_back(it.first, make_job<concrete_job>(job_fn(std::forward<decltype(it)>(it).second)));
+        items.back().second->slack(slack);
       }
-      _t = std::thread(runner, this);
-      _started.wait();
-      // t.detach();
-      dbg_trace("[runner] started.");
+      std::vector<timer_handle> handles;
+      handles.reserve(items.size());
+      _sched->registry().attach_all(
+              items.begin(), items.end(), [](auto &it) -> job_base & { return *it.second; }, handles, &_owner);
+
+      std::stable_sort(items.begin(), items.end(), [](auto const &a, auto const &b) { return a.first < b.first; });
+      _sched->add_sorted(std::move(items));
+      return handles;
     }
-
-    static void runner(timer_t *_this) { _this->runner_loop(); }
-    void runner_loop() {
-      bool ret;
-      using namespace std::literals::chrono_literals;
-      const auto starting_gap = 10ns;
-      std::chrono::nanoseconds d = starting_gap;
-#if defined(_DEBUG) || TICKER_CXX_TEST_THREAD_POOL_DBGOUT
-      std::size_t hit{0}, loop{0};
-#endif
-      _started.set();
-      dbg_trace("[runner] ready...");
-      while ((ret = _tk.wait_for(d)) != _tk.ConditionMatched) {
-        // std::this_thread::sleep_for(d);
-        dbg_debug("[runner] waked up. (_tk.terminated() == %d, ret=%d)", _tk.terminated(), ret);
-        d = _larger_gap;
-
-        TP picked;
-        Jobs jobs, recurred_jobs;
-        {
-          auto [itp, itn, found] = find_next();
-          if (!found) {
-            dbg_debug("[runner] find_next() returned not found");
-            continue;
-          }
-
-          dbg_debug("[runner] found a time-point");
-          // got a picked point
-          std::unique_lock<std::mutex> l(_l_twl);
-          (*itp).second.swap(jobs);
-          picked = (*itp).first;
-
-          // erase all expired jobs
-          _twl.erase(_twl.begin(), itp);
-
-          if (itn != _twl.end()) {
-            auto next_tp = (*itn).first;
-            d = (next_tp - picked);
-            if (d > _wastage)
-              d -= _wastage;
-#if defined(_DEBUG) || TICKER_CXX_TEST_THREAD_POOL_DBGOUT
-            if ((hit % 10) == 0)
-              pool_debug("[runner] [size: %u, hit: %u, loop: %u] picked = %s, next_tp = %s, duration = %s",
-                         _twl.size(), hit, loop,
-                         chrono::format_time_point(picked).c_str(),
-                         chrono::format_time_point(next_tp).c_str(),
-                         chrono::format_duration(d).c_str());
-            hit++;
-#endif
-          }
-        }
-
-        // launch the jobs
-        for (auto it = jobs.begin(); it != jobs.end(); ++it) {
-          std::shared_ptr<Job> &j = (*it);
-          if (j->_interval) {
-            // pool_debug("[runner] job starting, _interval");
-            j->launch_to(_pool, [&](timer_job *tj) {
-              add_task(tj->next_time_point(), std::move(j));
-            });
-          } else if (j->_recur) {
-            // pool_debug("[runner] job starting, _recur");
-            j->launch_to(_pool);
-            recurred_jobs.emplace_back(std::move(j));
-          } else {
-            // pool_debug("[runner] job starting");
-            j->launch_to(_pool);
-          }
-        }
-
-        // hold all past jobs to avoid heap-use-after-free sanitization
-        _pasts.emplace(picked, std::move(jobs));
-
-        for (auto &j : recurred_jobs) {
-          auto tp = j->next_time_point();
-#if defined(_DEBUG) || TICKER_CXX_TEST_THREAD_POOL_DBGOUT
-          auto dur = ((detail::every_job<Clock, GMT> *) j.get())->dur;
-          auto size = add_task(tp, std::move(j));
-          if ((loop % 10) == 0)
-            pool_debug("[runner] [size: %u, hit: %u, loop: %u] _recur job/%d added: %s, dur = %s, d = %s",
-                       size, hit, loop, recurred_jobs.size(),
-                       chrono::format_time_point(tp).c_str(),
-                       chrono::format_duration(dur).c_str(),
-                       chrono::format_duration(d).c_str());
-          UNUSED(size, dur);
-          loop++;
-#else
-          add_task(tp, std::move(j));
-#endif
-          d = tp - Clock::now();
-          if (d > _wastage)
-            d -= _wastage;
-        }
-      }
-      dbg_debug("[runner] timer::runner ended (_tk.terminated() == %d, ret = %d).", _tk.terminated(), ret);
-      _ended.set();
+    std::vector<timer_handle> schedule_many(std::vector<std::pair<TP, std::function<void()>>> &&items, std::chrono::nanoseconds slack = std::chrono::nanoseconds::zero()) {
+      return schedule_many(std::make_move_iterator(items.begin()), std::make_move_iterator(items.end()), slack);
     }
-    std::tuple<typename TimingWheel::iterator, typename TimingWheel::iterator, bool>
-    find_next() {
-      auto time_now = Clock::to_time_t(Clock::now());
-      bool found{};
-
-      std::unique_lock<std::mutex> l(_l_twl);
-
-      typename TimingWheel::iterator itn = _twl.end();
-      typename TimingWheel::iterator itp = itn;
-
-      for (auto it = _twl.begin(); it != itn; ++it) {
-        auto &tp = (*it).first;
-        auto tmp = Clock::to_time_t(tp);
-        if (tmp > time_now) break;
-        itp = it, found = true;
-        continue;
-      }
-
-      if (found) {
-        itn = itp;
-        itn++;
-      }
-      return {itp, itn, found};
+    /**
+         * @brief the count of the jobs of this timer which can be
+         * cancelled by their handles
+         */
+    std::size_t pending_handles() const { return _sched->registry().size(_owner); }
+    /**
+         * @brief choose how the runner thread of the scheduler waits for
+         * the deadlines, see scheduler::wait_strategy().
+         */
+    void wait_strategy(pool::wait_strategy s, std::chrono::nanoseconds spin_window = std::chrono::nanoseconds::zero()) {
+      _sched->wait_strategy(s, spin_window);
     }
+    pool::wait_strategy wait_strategy() const { return _sched->wait_strategy(); }
+    std::chrono::nanoseconds spin_window() const { return _sched->spin_window(); }
+    /**
+         * @brief the runner wakeups of the scheduler which fired jobs
+         */
+    std::size_t wakeups() const { return _sched->wakeups(); }
+    /**
+         * @brief the slacked jobs fired before their own deadlines, each
+         * of them shared a wakeup instead of taking one.
+         */
+    std::size_t coalesced_wakeups() const { return _sched->coalesced_wakeups(); }
+    /**
+         * @brief the counters of the slab arena of the scheduler, which
+         * the jobs and the queue buckets are allocated from.
+         */
+    pool::slab_stats allocator_stats() const { return _sched->allocator_stats(); }
 
   protected:
-    std::size_t add_task(TP const &tp, std::shared_ptr<Job> &&task) {
-      std::size_t size;
-      {
-        std::unique_lock<std::mutex> l(_l_twl);
-        auto it = _twl.find(tp);
-        if (it == _twl.end()) {
-          Jobs coll;
-          coll.emplace_back(std::move(task));
-          _twl.emplace(tp, std::move(coll));
-          pool_debug("add_task, tp not found. pool.size=%lu", _twl.size());
-        } else {
-          auto &coll = (*it).second;
-          coll.emplace_back(std::move(task));
-          pool_debug("add_task, tp found. pool.size=%lu", _twl.size());
-        }
-        size = _twl.size();
-      }
-      std::this_thread::yield();
-      return size;
+    std::size_t add_task(TP const &tp, std::shared_ptr<Job> &&task) { return _sched->add(tp, std::move(task)); }
+    // the jobs are allocated from the slab arena of the scheduler
+    template<typename J, typename... Args>
+    std::shared_ptr<J> make_job(Args &&...args) { return _sched->template make_job<J>(std::forward<Args>(args)...); }
+    std::size_t remove_task(TP const &tp, std::shared_ptr<Job> const &task) { return _sched->remove(tp, task); }
+
+    // the callable of on() for the job to build, which moves it out:
+    // each build() needs its own on(), a second one is rejected here
+    // instead of scheduling an empty job_fn
+    job_fn take_fn() {
+      if (!_f) throw std::logic_error("build(): no callable, call on() before each build()");
+      return std::move(_f);
     }
-    std::size_t remove_task(TP const &tp, std::shared_ptr<Job> const &task) {
-      std::size_t size;
-      {
-        std::unique_lock<std::mutex> l(_l_twl);
-
-        auto it = _twl.find(tp);
-        if (it != _twl.end()) {
-          auto &coll = (*it).second;
-          coll.erase(std::remove(coll.begin(), coll.end(), task), coll.end());
-        }
-        size = _twl.size();
-      }
-      std::this_thread::yield();
-      return size;
+    // applies the builder options to a new job, and attaches its handle
+    timer_handle attach_job(Job &j) {
+      j.slack(std::exchange(_slack, std::chrono::nanoseconds::zero()));
+      return _sched->registry().attach(j, &_owner);
     }
 
   protected:
     typename Clock::time_point _tp{};
-    std::function<void()> _f{nullptr};
+    job_fn _f{nullptr};
+    std::chrono::nanoseconds _slack{0};
 
   private:
-    std::thread _t;
-    pool::timer_killer _tk{}; // to shut down the sleep+loop in `runner` thread gracefully
-    TimingWheel _twl{};
-    TimingWheel _pasts{};
-    std::mutex _l_twl{};
-    pool::thread_pool _pool;
-    pool::conditional_wait_for_bool _started{}, _ended{};                   // runner thread terminated.
-    std::chrono::nanoseconds _larger_gap = std::chrono::milliseconds(3000); // = 3s
-    std::chrono::nanoseconds _wastage = std::chrono::milliseconds(0);
+    std::shared_ptr<scheduler_type> _sched;
+    detail::job_owner _owner{}; // the jobs of this front-end in the registry of _sched
   }; // class timer
 
   /**
@@ -396,14 +385,19 @@ namespace ticker {
   template<typename DerivedT = std::nullopt_t,
            typename Clock = Clock,
            bool GMT = false,
-           typename ConcreteJob = detail::every_job<Clock, GMT>>
-  class ticker_t : public timer_t<typename std::conditional<std::is_same_v<std::nullopt_t, DerivedT>, ticker_t<DerivedT, Clock, GMT, ConcreteJob>, DerivedT>::type, Clock, GMT, ConcreteJob> {
+           typename ConcreteJob = detail::every_job<Clock, GMT>,
+           typename QueuePolicy = queue::map_policy,
+           typename Waiter = pool::timer_killer>
+  class ticker_t : public timer_t<typename std::conditional<std::is_same_v<std::nullopt_t, DerivedT>, ticker_t<DerivedT, Clock, GMT, ConcreteJob, QueuePolicy, Waiter>, DerivedT>::type, Clock, GMT, ConcreteJob, QueuePolicy, Waiter> {
   public:
-    ticker_t(ticker_t const &o) { __copy(o); }
-    ticker_t(ticker_t &&o) { __copy(o); }
+    // a copy shares the scheduler of o, as a copy of timer_t does
+    ticker_t(ticker_t const &o)
+        : super(o) { __copy(o); }
+    ticker_t(ticker_t &&o)
+        : super(o) { __copy(o); }
     ~ticker_t() override = default;
-    using _This = ticker_t<DerivedT, Clock, GMT, ConcreteJob>;
-    using super = timer_t<typename std::conditional<std::is_same_v<std::nullopt_t, DerivedT>, _This, DerivedT>::type, Clock, GMT, ConcreteJob>;
+    using _This = ticker_t<DerivedT, Clock, GMT, ConcreteJob, QueuePolicy, Waiter>;
+    using super = timer_t<typename std::conditional<std::is_same_v<std::nullopt_t, DerivedT>, _This, DerivedT>::type, Clock, GMT, ConcreteJob, QueuePolicy, Waiter>;
     using base_t = typename super::base_t;
     // struct __W : public ticker<Clock, GMT, ConcreteJob> {
     //     __W() = default;
@@ -418,23 +412,41 @@ namespace ticker {
     // }
 
     typename base_t::__D &every(const typename Clock::duration time) {
-      _dur = time, _interval = false;
+      _dur = time, _interval = false, _fixed_rate = false, _misfire = misfire::coalesce;
       return static_cast<typename base_t::__D &>(*this);
     }
+    /**
+         * @brief make the every() job fire on a fixed rate anchored to
+         * its first due time, instead of a fixed delay after each firing.
+         * @param policy what to do with the periods missed while stalled
+         */
+    typename base_t::__D &fixed_rate(misfire policy = misfire::coalesce) {
+      _fixed_rate = true, _misfire = policy;
+      return static_cast<typename base_t::__D &>(*this);
+    }
+    // a period after each run completes; clears a fixed_rate() set before
     typename base_t::__D &interval(const typename Clock::duration time) {
-      _dur = time, _interval = true;
+      _dur = time, _interval = true, _fixed_rate = false, _misfire = misfire::coalesce;
       return static_cast<typename base_t::__D &>(*this);
     }
 
-    void build() {
-      auto copy_fn = super::_f;
-      std::shared_ptr<typename super::Job> t = std::make_shared<ConcreteJob>(_dur, std::move(copy_fn));
-      auto next_time = t->next_time_point();
-      dbg_debug("next_time: %s", chrono::format_time_point(next_time).c_str());
-      if (_interval)
-        super::add_task(Clock::now(), std::move(t));
+    timer_handle build() {
+      using J = typename super::concrete_job;
+      std::shared_ptr<J> j;
+      if constexpr (std::is_constructible_v<J, typename Clock::duration, job_fn &&, bool>)
+        j = super::template make_job<J>(_dur, super::take_fn(), _interval); // re-added once each run completes
       else
-        super::add_task(next_time, std::move(t));
+        j = super::template make_job<J>(_dur, super::take_fn());
+      if constexpr (std::is_base_of_v<detail::every_job<Clock, GMT>, typename super::concrete_job>) {
+        if (_fixed_rate)
+          j->fixed_rate(_misfire);
+      }
+      std::shared_ptr<typename super::Job> t = std::move(j);
+      // the first period is a query; the runner advances the job on each firing
+      auto next_time = _interval ? Clock::now() : t->next_time_point();
+      auto h = super::attach_job(*t);
+      super::add_task(next_time, std::move(t));
+      return h;
     }
 
     // template<typename _Callable, typename... _Args>
@@ -445,25 +457,35 @@ namespace ticker {
 
   protected:
     ticker_t() = default;
+    template<typename Service>
+    explicit ticker_t(std::shared_ptr<Service> s)
+        : super(std::move(s)) {}
     // CLAZZ_NON_MOVEABLE(ticker);
     void __copy(ticker_t const &o) {
       super::__copy(o);
       __COPY(_dur);
       __COPY(_interval);
+      __COPY(_fixed_rate);
+      __COPY(_misfire);
     }
 
     typename Clock::duration _dur;
     bool _interval{false};
+    bool _fixed_rate{false};
+    misfire _misfire{misfire::coalesce};
   }; // class ticker_t
 
-  template<typename DerivedT = std::nullopt_t, typename Clock = Clock, bool GMT = false, typename ConcreteJob = detail::periodical_job<Clock, GMT>>
-  class alarm_t : public ticker_t<typename std::conditional<std::is_same_v<std::nullopt_t, DerivedT>, alarm_t<DerivedT, Clock, GMT, ConcreteJob>, DerivedT>::type, Clock, GMT, ConcreteJob> {
+  template<typename DerivedT = std::nullopt_t, typename Clock = Clock, bool GMT = false, typename ConcreteJob = detail::periodical_job<Clock, GMT>, typename QueuePolicy = queue::map_policy, typename Waiter = pool::timer_killer>
+  class alarm_t : public ticker_t<typename std::conditional<std::is_same_v<std::nullopt_t, DerivedT>, alarm_t<DerivedT, Clock, GMT, ConcreteJob, QueuePolicy, Waiter>, DerivedT>::type, Clock, GMT, ConcreteJob, QueuePolicy, Waiter> {
   public:
-    alarm_t(alarm_t const &o) { __copy(o); }
-    alarm_t(alarm_t &&o) { __copy(o); }
+    // a copy shares the scheduler of o, as a copy of timer_t does
+    alarm_t(alarm_t const &o)
+        : super(o) { __copy(o); }
+    alarm_t(alarm_t &&o)
+        : super(o) { __copy(o); }
     ~alarm_t() override = default;
-    using _This = alarm_t<DerivedT, Clock, GMT, ConcreteJob>;
-    using super = ticker_t<typename std::conditional<std::is_same_v<std::nullopt_t, DerivedT>, _This, DerivedT>::type, Clock, GMT, ConcreteJob>;
+    using _This = alarm_t<DerivedT, Clock, GMT, ConcreteJob, QueuePolicy, Waiter>;
+    using super = ticker_t<typename std::conditional<std::is_same_v<std::nullopt_t, DerivedT>, _This, DerivedT>::type, Clock, GMT, ConcreteJob, QueuePolicy, Waiter>;
     using base_t = typename super::base_t;
 
     typename base_t::__D &every_month(int day_offset = 1, int how_many = 1, int repeat_times = 0) {
@@ -478,15 +500,20 @@ namespace ticker {
       return static_cast<typename base_t::__D &>(*this);
     }
 
-    void build() {
-      std::shared_ptr<typename super::Job> t = std::make_shared<ConcreteJob>(_anchor, _ordinal, _offset, _times, std::move(super::_f));
+    timer_handle build() {
+      std::shared_ptr<typename super::Job> t = super::template make_job<typename super::concrete_job>(_anchor, _ordinal, _offset, _times, super::take_fn());
       auto next_time = t->next_time_point();
       dbg_debug("anchor: %d, count: %d, next_time: %s", _anchor, _ordinal, chrono::format_time_point(next_time).c_str());
+      auto h = super::attach_job(*t);
       super::add_task(next_time, std::move(t));
+      return h;
     }
 
   protected:
     alarm_t() = default;
+    template<typename Service>
+    explicit alarm_t(std::shared_ptr<Service> s)
+        : super(std::move(s)) {}
     // CLAZZ_NON_MOVABLE(alarm);
     void __copy(alarm_t const &o) {
       super::__copy(o);
@@ -502,6 +529,22 @@ namespace ticker {
     int _times{0};
   }; // class alarm
 
+  /**
+     * @brief the timer and the ticker on the monotonic clock, the
+     * relative in()/every() jobs of them are immune to the wall clock
+     * steps (NTP, settimeofday). alarm_t stays on the wall clock.
+     */
+  using steady_timer = timer_t<std::nullopt_t, std::chrono::steady_clock>;
+  using steady_ticker = ticker_t<std::nullopt_t, std::chrono::steady_clock>;
+
+  /**
+     * @brief the timer and the ticker whose schedulers hold their job
+     * kind statically, see ticker::static_job. They can't share a
+     * scheduler with the other front-ends.
+     */
+  using static_timer = timer_t<std::nullopt_t, Clock, false, static_job<detail::in_job<Clock, false>>>;
+  using static_ticker = ticker_t<std::nullopt_t, Clock, false, static_job<detail::every_job<Clock, false>>>;
+
 } // namespace ticker
 
 namespace ticker::test {
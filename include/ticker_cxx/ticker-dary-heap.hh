@@ -0,0 +1,148 @@
+// ticker_cxx Library
+// Copyright © 2021 Hedzr Yeh.
+//
+// This file is released under the terms of the MIT license.
+// Read /LICENSE for more information.
+
+//
+// Created by Hedzr Yeh on 2021/11/03.
+//
+
+#ifndef TICKER_CXX_TICKER_DARY_HEAP_HH
+#define TICKER_CXX_TICKER_DARY_HEAP_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace ticker::queue {
+
+  /**
+     * @brief an implicit d-ary min-heap of pending jobs, stored in one contiguous vector.
+     * @tparam Clock  the clock of the time points
+     * @tparam J      the job handle type, such as `std::shared_ptr<timer_job>`
+     * @tparam Arity  the children count of each node, 4 by default
+     *
+     * @details A 4-ary heap is half as deep as a binary heap and the
+     * children of a node sit in one or two cache lines, so sifting down
+     * touches fewer lines. add() and pop are O(log n), there's no
+     * per-job node allocation besides the vector growth.
+     *
+     * Jobs with the same time point fire in insertion order.
+     *
+     * @note dary_heap_queue is not thread-safe, the owner holds the lock.
+     */
+  template<typename Clock, typename J, std::size_t Arity = 4>
+  class dary_heap_queue {
+  public:
+    using time_point = typename Clock::time_point;
+    using job_type = J;
+    using jobs_t = std::vector<J>;
+    using items_t = std::vector<std::pair<time_point, J>>;
+    static_assert(Arity >= 2, "dary_heap_queue: Arity must be 2 at least");
+
+    std::size_t add(time_point const &tp, J &&job) {
+      _heap.emplace_back(entry{tp, _seq++, std::move(job)});
+      sift_up(_heap.size() - 1);
+      return _heap.size();
+    }
+    // a large batch is appended then heapified bottom-up in O(n)
+    std::size_t add_sorted(items_t &&items) {
+      const std::size_t old_size = _heap.size();
+      _heap.reserve(old_size + items.size());
+      for (auto &it : items)
+        _heap.emplace_back(entry{it.first, _seq++, std::move(it.second)});
+      if (items.size() > old_size) {
+        if (_heap.size() > 1)
+          for (std::size_t i = (_heap.size() - 2) / Arity + 1; i-- > 0;)
+            sift_down(i);
+      } else {
+        for (std::size_t i = old_size; i < _heap.size(); ++i)
+          sift_up(i);
+      }
+      return _heap.size();
+    }
+    // O(n): the heap is not indexed by job
+    std::size_t remove(time_point const &tp, J const &job) {
+      for (std::size_t i = 0; i < _heap.size(); ++i) {
+        if (_heap[i].tp == tp && _heap[i].job == job) {
+          erase_at(i);
+          break;
+        }
+      }
+      return _heap.size();
+    }
+    bool pop_expired(time_point const &now, jobs_t &out) {
+      bool found{};
+      while (!_heap.empty() && !(now < _heap.front().tp)) {
+        out.emplace_back(std::move(_heap.front().job));
+        erase_at(0);
+        found = true;
+      }
+      return found;
+    }
+    bool next_time_point(time_point &tp) const {
+      if (_heap.empty()) return false;
+      tp = _heap.front().tp;
+      return true;
+    }
+    std::size_t size() const { return _heap.size(); }
+    bool empty() const { return _heap.empty(); }
+    void clear() { _heap.clear(); }
+
+  private:
+    struct entry {
+      time_point tp;
+      std::uint64_t seq;
+      J job;
+    };
+    static bool less(entry const &a, entry const &b) { return a.tp < b.tp || (a.tp == b.tp && a.seq < b.seq); }
+
+    void erase_at(std::size_t i) {
+      if (i + 1 != _heap.size()) {
+        _heap[i] = std::move(_heap.back());
+        _heap.pop_back();
+        if (i > 0 && less(_heap[i], _heap[(i - 1) / Arity]))
+          sift_up(i);
+        else
+          sift_down(i);
+      } else {
+        _heap.pop_back();
+      }
+    }
+    void sift_up(std::size_t i) {
+      entry e = std::move(_heap[i]);
+      while (i > 0) {
+        std::size_t parent = (i - 1) / Arity;
+        if (!less(e, _heap[parent])) break;
+        _heap[i] = std::move(_heap[parent]);
+        i = parent;
+      }
+      _heap[i] = std::move(e);
+    }
+    void sift_down(std::size_t i) {
+      const std::size_t n = _heap.size();
+      entry e = std::move(_heap[i]);
+      for (;;) {
+        std::size_t first = i * Arity + 1;
+        if (first >= n) break;
+        std::size_t last = first + Arity < n ? first + Arity : n;
+        std::size_t best = first;
+        for (std::size_t c = first + 1; c < last; ++c)
+          if (less(_heap[c], _heap[best])) best = c;
+        if (!less(_heap[best], e)) break;
+        _heap[i] = std::move(_heap[best]);
+        i = best;
+      }
+      _heap[i] = std::move(e);
+    }
+
+  private:
+    std::vector<entry> _heap{};
+    std::uint64_t _seq{0};
+  }; // class dary_heap_queue
+
+} // namespace ticker::queue
+
+#endif //TICKER_CXX_TICKER_DARY_HEAP_HH
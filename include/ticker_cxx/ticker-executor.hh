@@ -0,0 +1,99 @@
+// ticker_cxx Library
+// Copyright © 2021 Hedzr Yeh.
+//
+// This file is released under the terms of the MIT license.
+// Read /LICENSE for more information.
+
+//
+// Created by Hedzr Yeh on 2021/11/12.
+//
+
+#ifndef TICKER_CXX_TICKER_EXECUTOR_HH
+#define TICKER_CXX_TICKER_EXECUTOR_HH
+
+#include "ticker-small-function.hh"
+
+#include <chrono>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace ticker::pool {
+
+  /**
+     * @brief the tasks posted to the executors, move-only
+     */
+  using task_fn = util::small_function<void()>;
+
+  /**
+     * @brief whether E is an executor: `e.post(f)` runs the callable f
+     * sometime, on some thread, and returns at once. f may be move-only,
+     * a task_fn.
+     */
+  template<typename E, typename = void>
+  struct is_executor : std::false_type {};
+  template<typename E>
+  struct is_executor<E, std::void_t<decltype(std::declval<E &>().post(std::declval<task_fn>()))>> : std::true_type {};
+  template<typename E>
+  inline constexpr bool is_executor_v = is_executor<E>::value;
+
+  /**
+     * @brief the time a posted task is due to run, on the steady clock
+     */
+  using deadline_t = std::chrono::steady_clock::time_point;
+
+  /**
+     * @brief whether E takes the deadline of a task: `e.post(f, deadline)`,
+     * such as pool::basic_thread_pool<pool::discipline::edf>.
+     */
+  template<typename E, typename = void>
+  struct is_deadline_executor : std::false_type {};
+  template<typename E>
+  struct is_deadline_executor<E, std::void_t<decltype(std::declval<E &>().post(std::declval<task_fn>(), std::declval<deadline_t>()))>> : std::true_type {};
+  template<typename E>
+  inline constexpr bool is_deadline_executor_v = is_deadline_executor<E>::value;
+
+  /**
+     * @brief runs the posted callable right away on the calling thread.
+     * @details A scheduler on it fires the jobs on its runner thread,
+     * for the jobs cheap enough not to delay the other deadlines.
+     */
+  struct inline_executor {
+    template<typename F>
+    void post(F &&f) { std::forward<F>(f)(); }
+  };
+
+  /**
+     * @brief a type-erased, shared reference to an executor.
+     * @details The scheduler posts the jobs through it, so any executor
+     * (thread_pool, inline_executor, an I/O executor of the application)
+     * can run them without changing the type of the timer.
+     */
+  class any_executor {
+  public:
+    any_executor() = default;
+    template<typename E, typename = std::enable_if_t<is_executor_v<E>>>
+    explicit any_executor(std::shared_ptr<E> e)
+        : _e(std::move(e))
+        , _post([](void *p, task_fn &&f) { static_cast<E *>(p)->post(std::move(f)); })
+        , _post_by([](void *p, task_fn &&f, deadline_t d) {
+          if constexpr (is_deadline_executor_v<E>)
+            static_cast<E *>(p)->post(std::move(f), d);
+          else
+            static_cast<E *>(p)->post(std::move(f));
+        }) {}
+
+    void post(task_fn &&f) const { _post(_e.get(), std::move(f)); }
+    // the deadline is dropped if the executor doesn't take it
+    void post(task_fn &&f, deadline_t d) const { _post_by(_e.get(), std::move(f), d); }
+    explicit operator bool() const { return _e != nullptr; }
+
+  private:
+    std::shared_ptr<void> _e{};
+    void (*_post)(void *, task_fn &&){nullptr};
+    void (*_post_by)(void *, task_fn &&, deadline_t){nullptr};
+  }; // class any_executor
+
+} // namespace ticker::pool
+
+#endif //TICKER_CXX_TICKER_EXECUTOR_HH
@@ -0,0 +1,107 @@
+// ticker_cxx Library
+// Copyright © 2021 Hedzr Yeh.
+//
+// This file is released under the terms of the MIT license.
+// Read /LICENSE for more information.
+
+//
+// Created by Hedzr Yeh on 2021/11/15.
+//
+
+#ifndef TICKER_CXX_TICKER_INTRUSIVE_LIST_HH
+#define TICKER_CXX_TICKER_INTRUSIVE_LIST_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace ticker::queue {
+
+  /**
+     * @brief the links a job embeds to sit in an intrusive_list.
+     * @details While the job is linked, the list holds it by `self`,
+     * moved in from the caller, so linking and unlinking touch no
+     * reference count and allocate nothing.
+     * @tparam T the job type, which exposes `intrusive_hook<T> *queue_hook()`
+     */
+  template<typename T>
+  struct intrusive_hook {
+    std::shared_ptr<T> self{}; // the reference held by the list while linked
+    T *prev{nullptr}, *next{nullptr};
+    void const *list{nullptr}; // the list linked to, so a stray remove() is harmless
+    std::int64_t expire{};     // the tick of the timing wheel
+  };
+
+  /**
+     * @brief a doubly-linked FIFO of jobs threaded through their own
+     * intrusive_hook, a bucket of timing_wheel.
+     * @details push() and remove() are O(1). A job is in one list at a
+     * time; the list must not move while it holds any.
+     * @tparam J the job handle, `std::shared_ptr<T>`
+     */
+  template<typename J>
+  class intrusive_list {
+  public:
+    using job_type = J;
+    using element_type = typename J::element_type;
+
+    intrusive_list() = default;
+    intrusive_list(intrusive_list const &) = delete;
+    intrusive_list &operator=(intrusive_list const &) = delete;
+    ~intrusive_list() { clear(); }
+
+    void push(std::int64_t expire, J &&job) {
+      element_type *p = job.get();
+      auto &h = hook(p);
+      h.expire = expire, h.list = this;
+      h.prev = _tail, h.next = nullptr;
+      (_tail ? hook(_tail).next : _head) = p;
+      _tail = p, ++_size;
+      h.self = std::move(job);
+    }
+    // unlinks job if it's in this list
+    bool remove(J const &job) {
+      element_type *p = job.get();
+      auto &h = hook(p);
+      if (h.list != this) return false;
+      (h.prev ? hook(h.prev).next : _head) = h.next;
+      (h.next ? hook(h.next).prev : _tail) = h.prev;
+      --_size;
+      h.prev = h.next = nullptr, h.list = nullptr;
+      h.self.reset(); // the caller still holds job
+      return true;
+    }
+    /**
+         * @brief unlink all jobs in FIFO order, f(expire, J &&) takes each.
+         * @details The list is emptied first, so f may push a job back.
+         */
+    template<typename F>
+    void drain(F &&f) {
+      element_type *p = std::exchange(_head, nullptr);
+      _tail = nullptr, _size = 0;
+      while (p) {
+        auto &h = hook(p);
+        element_type *next = h.next;
+        h.prev = h.next = nullptr, h.list = nullptr;
+        J job = std::move(h.self);
+        f(h.expire, std::move(job));
+        p = next;
+      }
+    }
+    void clear() {
+      drain([](std::int64_t, J &&) {});
+    }
+    bool empty() const { return _head == nullptr; }
+    std::size_t size() const { return _size; }
+
+  private:
+    static intrusive_hook<element_type> &hook(element_type *p) { return *p->queue_hook(); }
+
+    element_type *_head{nullptr}, *_tail{nullptr};
+    std::size_t _size{0};
+  }; // class intrusive_list
+
+} // namespace ticker::queue
+
+#endif //TICKER_CXX_TICKER_INTRUSIVE_LIST_HH
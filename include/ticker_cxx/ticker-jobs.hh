@@ -15,28 +15,82 @@
 #include "ticker-periodical-job.hh"
 #include "ticker-timer-job.hh"
 
+namespace ticker {
+
+  /**
+     * @brief what a fixed-rate job does with the periods it missed, such
+     * as while the process was stalled.
+     */
+  enum class misfire {
+    fire_all, // fire once for each missed period, back to back
+    coalesce, // fire once for all of the missed periods
+    skip,     // don't fire for the missed periods, wait for the next one
+  };
+
+  /**
+     * @brief marks the ConcreteJob of a timer_t, ticker_t or alarm_t for
+     * the static dispatch.
+     * @details The scheduler of such a front-end holds the jobs by their
+     * concrete type instead of basic_timer_job, so the runner calls the
+     * advance() of it by the qualified name, not virtually, and skips
+     * the recurrence checks of a one-shot job kind. Only the front-ends
+     * of the same ConcreteJob can share such a scheduler, and it holds
+     * the jobs of that very type: a job derived from ConcreteJob goes
+     * to a scheduler of basic_timer_job, or of static_job<Derived>.
+     * @code{c++}
+     * using fast_ticker = ticker::ticker_t<std::nullopt_t, ticker::Clock, false,
+     *                                      ticker::static_job<ticker::detail::every_job<>>>;
+     * @endcode
+     * @see static_timer, static_ticker
+     */
+  template<typename ConcreteJob>
+  struct static_job {
+    using type = ConcreteJob;
+  };
+
+  namespace detail {
+    // the job type of the ConcreteJob parameter, and whether it's a static_job
+    template<typename J>
+    struct job_of {
+      using type = J;
+      static constexpr bool is_static = false;
+    };
+    template<typename J>
+    struct job_of<static_job<J>> {
+      using type = J;
+      static constexpr bool is_static = true;
+    };
+  } // namespace detail
+
+} // namespace ticker
+
 namespace ticker::detail {
 
   template<typename Clock = Clock, bool GMT = false>
-  class in_job : public timer_job {
+  class in_job : public basic_timer_job<Clock> {
   public:
-    explicit in_job(std::function<void()> &&f)
-        : timer_job(std::move(f)) {}
+    explicit in_job(job_fn &&f)
+        : basic_timer_job<Clock>(std::move(f)) {}
     virtual ~in_job() {}
 
+    static constexpr bool one_shot = true; // never recurs, see is_one_shot; a derived job which recurs hides it by false
+    using basic_timer_job<Clock>::next_time_point;
     using time_point = typename Clock::time_point;
     // dummy time_point because it's not used
     typename Clock::time_point next_time_point(time_point const) const override { return time_point{typename Clock::duration(0)}; }
   };
 
   template<typename Clock = Clock, bool GMT = false>
-  class every_job : public timer_job {
+  class every_job : public basic_timer_job<Clock> {
   public:
-    explicit every_job(typename Clock::duration d, std::function<void()> &&f, bool interval = false)
-        : timer_job(std::move(f), true, interval), dur(d) {}
+    explicit every_job(typename Clock::duration d, job_fn &&f, bool interval = false)
+        : basic_timer_job<Clock>(std::move(f), true, interval), dur(d) {}
     virtual ~every_job() {}
 
+    using basic_timer_job<Clock>::next_time_point;
     typename Clock::time_point next_time_point(typename Clock::time_point const now) const override {
+      if (_fixed_rate)
+        return next_fixed_rate(now);
 #if defined(_DEBUG) || TICKER_CXX_TEST_THREAD_POOL_DBGOUT
       auto nxt = now + dur;
       pool_debug("         %s -> %s", chrono::format_time_point(now).c_str(), chrono::format_time_point(nxt).c_str());
@@ -45,8 +99,49 @@ namespace ticker::detail {
       return now + dur;
 #endif
     };
+    // a fixed-rate job moves on from the period it was due at
+    typename Clock::time_point advance(typename Clock::time_point const now) override {
+      if (!_fixed_rate)
+        return next_time_point(now);
+      return _next_due = next_fixed_rate(now);
+    }
+
+    /**
+         * @brief fire on a fixed rate: the periods are anchored to the
+         * first due time instead of the previous firing, so the dispatch
+         * latency doesn't accumulate.
+         * @param policy what to do with the periods missed
+         */
+    void fixed_rate(misfire policy) { _fixed_rate = true, _misfire = policy; }
+    bool fixed_rate() const { return _fixed_rate; }
 
     typename Clock::duration dur;
+
+  private:
+    // the period after the last one, or the first one from now if the
+    // job is not scheduled yet
+    typename Clock::time_point next_fixed_rate(typename Clock::time_point const now) const {
+      auto last = _next_due;
+      if (last == Clock::time_point::min()) {
+        if (this->due() == typename Clock::time_point{})
+          return now + dur;
+        last = this->due(); // the first period, as scheduled by build()
+      }
+      auto due = last + dur;
+      if (!(now < due) && dur > Clock::duration::zero()) {
+        auto missed = (now - due) / dur; // the periods missed besides due
+        switch (_misfire) {
+        case misfire::fire_all: break;
+        case misfire::coalesce: due += dur * missed; break;
+        case misfire::skip: due += dur * (missed + 1); break;
+        }
+      }
+      return due;
+    }
+
+    bool _fixed_rate{false};
+    misfire _misfire{misfire::coalesce};
+    typename Clock::time_point _next_due{Clock::time_point::min()}; // the period of the last firing, set by advance()
   };
 
 } // namespace ticker::detail
@@ -0,0 +1,87 @@
+// ticker_cxx Library
+// Copyright © 2021 Hedzr Yeh.
+//
+// This file is released under the terms of the MIT license.
+// Read /LICENSE for more information.
+
+//
+// Created by Hedzr Yeh on 2021/11/06.
+//
+
+#ifndef TICKER_CXX_TICKER_MPSC_INBOX_HH
+#define TICKER_CXX_TICKER_MPSC_INBOX_HH
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace ticker::queue {
+
+  /**
+     * @brief a lock-free multi-producer inbox, drained by one consumer at a time.
+     * @details Producers push onto an intrusive singly-linked stack with a
+     * CAS loop. The consumer detaches the whole stack with one exchange
+     * and reverses it, so the items come out in the order they were
+     * pushed. Since nodes are never popped one by one there is no ABA
+     * problem.
+     *
+     * push() and empty() are sequentially consistent, so a producer and
+     * a consumer can use a Dekker-style handshake: the producer pushes
+     * then reads a flag of the consumer, the consumer writes the flag
+     * then checks empty(). At least one of them sees the other.
+     * @tparam T the item type
+     */
+  template<typename T>
+  class mpsc_inbox {
+  public:
+    mpsc_inbox() = default;
+    mpsc_inbox(mpsc_inbox const &) = delete;
+    mpsc_inbox &operator=(mpsc_inbox const &) = delete;
+    ~mpsc_inbox() { drain([](T &&) {}); }
+
+    /**
+         * @brief push an item, never blocks.
+         * @return true if the inbox was empty
+         */
+    bool push(T &&v) {
+      node *n = new node{std::move(v), _head.load(std::memory_order_relaxed)};
+      while (!_head.compare_exchange_weak(n->next, n, std::memory_order_seq_cst, std::memory_order_relaxed))
+        ;
+      return n->next == nullptr;
+    }
+
+    /**
+         * @brief take all items out in FIFO order.
+         * @return the count of the items taken
+         */
+    template<typename F>
+    std::size_t drain(F &&f) {
+      node *h = _head.exchange(nullptr, std::memory_order_acquire);
+      node *rev = nullptr;
+      while (h) {
+        node *next = h->next;
+        h->next = rev, rev = h, h = next;
+      }
+      std::size_t count{};
+      while (rev) {
+        node *next = rev->next;
+        f(std::move(rev->value));
+        delete rev;
+        rev = next, ++count;
+      }
+      return count;
+    }
+
+    bool empty() const { return _head.load(std::memory_order_seq_cst) == nullptr; }
+
+  private:
+    struct node {
+      T value;
+      node *next;
+    };
+    std::atomic<node *> _head{nullptr};
+  }; // class mpsc_inbox
+
+} // namespace ticker::queue
+
+#endif //TICKER_CXX_TICKER_MPSC_INBOX_HH
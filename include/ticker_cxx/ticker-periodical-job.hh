@@ -14,15 +14,25 @@
 #include "ticker-anchors.hh"
 #include "ticker-timer-job.hh"
 
+#include <type_traits>
+
 namespace ticker::detail {
 
+  /**
+     * @brief a calendar job, such as the day 3 of every month.
+     * @details The anchors are wall clock dates, so a periodical_job
+     * stays on std::chrono::system_clock.
+     */
   template<typename Clock = std::chrono::system_clock, bool GMT = false>
-  class periodical_job : public timer_job {
+  class periodical_job : public basic_timer_job<Clock> {
+    static_assert(std::is_same_v<Clock, std::chrono::system_clock>, "periodical_job: the calendar alarms run on std::chrono::system_clock");
+
   public:
-    explicit periodical_job(anchors anchor_, int ordinal_, int offset_, int times_, std::function<void()> &&f, bool interval = false)
-        : timer_job(std::move(f), true, interval), last_pt(Clock::now()), anchor(anchor_), ordinal(ordinal_), offset(offset_), times(times_) {}
+    explicit periodical_job(anchors anchor_, int ordinal_, int offset_, int times_, job_fn &&f, bool interval = false)
+        : basic_timer_job<Clock>(std::move(f), true, interval), last_pt(Clock::now()), anchor(anchor_), ordinal(ordinal_), offset(offset_), times(times_) {}
     virtual ~periodical_job() {}
 
+    using basic_timer_job<Clock>::next_time_point;
     typename Clock::time_point next_time_point(typename Clock::time_point const now) const override {
       if (now < last_pt)
         return last_pt;
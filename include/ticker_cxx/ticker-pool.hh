@@ -20,10 +20,14 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <exception>
 #include <future>
 #include <mutex>
 #include <thread>
 
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <functional>
 #include <optional>
 #include <queue>
@@ -31,9 +35,11 @@
 #include <string>
 #include <vector>
 
+#include "ticker-affinity.hh"
 #include "ticker-def.hh"
+#include "ticker-executor.hh"
 #include "ticker-log.hh"
-// #include "ticker-ringbuf.hh"
+#include "ticker-ringbuf.hh"
 
 #if TICKER_CXX_TEST_THREAD_POOL_DBGOUT
 #define pool_debug dbg_print
@@ -288,6 +294,30 @@ namespace ticker::pool {
     bool wait_until() {
       return wait_until(std::chrono::time_point<std::chrono::system_clock>::max());
     }
+    /**
+         * @brief wait until a time point, or until killed or kicked.
+         * @return true if killed, false while timeout or kicked.
+         * @see kick()
+         */
+    template<class C, class D>
+    bool wait_until_or_kick(std::chrono::time_point<C, D> const &timeout_time) {
+      std::unique_lock<std::mutex> lk(_m);
+      _cv.wait_until(lk, timeout_time, [this] { return _var || _kicked; });
+      _kicked = false;
+      return _var;
+    }
+    /**
+         * @brief wake up the waiter in wait_until_or_kick() without killing it.
+         * @details A kick before the waiter sleeps is not lost, the next
+         * wait_until_or_kick() returns immediately.
+         */
+    void kick() {
+      {
+        std::unique_lock<std::mutex> lk(_m);
+        _kicked = true;
+      }
+      _cv.notify_one();
+    }
     void set() {
       dbg_debug("%s", __FUNCTION_NAME__);
       conditional_wait_for_bool::set();
@@ -307,6 +337,9 @@ namespace ticker::pool {
     //     if (go)
     //         _cv.notify_all(); // it is safe, and *sometimes* optimal, to do this outside the lock}
     // }
+
+  private:
+    bool _kicked{false};
   };
 
 } // namespace ticker::pool
@@ -314,35 +347,192 @@ namespace ticker::pool {
 // threaded_message_queue, thread_pool
 namespace ticker::pool {
 
-  template<class T, class Coll = std::deque<T>>
+  /**
+     * @brief the queue disciplines of threaded_message_queue: which of
+     * the queued items pop_front() takes.
+     * @details A discipline has a member class template `container<T>`:
+     * @code{c++}
+     *   void push(T &&t);
+     *   T pop();          // not empty
+     *   bool empty() const;
+     *   std::size_t size() const;
+     *   void clear();
+     * @endcode
+     */
+  namespace discipline {
+
+    /**
+         * @brief first in, first out: the oldest item never starves.
+         * @details The items are kept in a ring which doubles when it's
+         * full, so a steady flow allocates nothing, unlike a std::deque
+         * whose blocks come and go as its front moves on. T must be
+         * default constructible.
+         */
+    struct fifo {
+      template<class T>
+      class container {
+      public:
+        void push(T &&t) {
+          if (_size == _c.size()) grow();
+          _c[(_head + _size++) & (_c.size() - 1)] = std::move(t);
+        }
+        T pop() {
+          T t = std::move(_c[_head]);
+          _c[_head] = T{}; // releases what the item holds
+          _head = (_head + 1) & (_c.size() - 1), --_size;
+          return t;
+        }
+        bool empty() const { return _size == 0; }
+        std::size_t size() const { return _size; }
+        void clear() {
+          while (_size > 0) pop();
+        }
+
+      private:
+        void grow() {
+          std::vector<T> c(_c.empty() ? 16 : _c.size() * 2);
+          for (std::size_t i = 0; i < _size; ++i) c[i] = std::move(_c[(_head + i) & (_c.size() - 1)]);
+          _c.swap(c), _head = 0;
+        }
+        std::vector<T> _c{}; // the ring, a power of two in size
+        std::size_t _head{0}, _size{0};
+      };
+    };
+
+    /**
+         * @brief last in, first out: the newest item is hot in cache, but
+         * under overload the oldest ones wait until the backlog is gone.
+         */
+    struct lifo {
+      template<class T>
+      class container {
+      public:
+        void push(T &&t) { _c.emplace_back(std::move(t)); }
+        T pop() {
+          T t = std::move(_c.back());
+          _c.pop_back();
+          return t;
+        }
+        bool empty() const { return _c.empty(); }
+        std::size_t size() const { return _c.size(); }
+        void clear() { _c.clear(); }
+
+      private:
+        std::vector<T> _c{};
+      };
+    };
+
+    /**
+         * @brief earliest deadline first, by the `deadline` member of the
+         * items, such as pool_task; the equal deadlines go FIFO. It
+         * minimises the maximum lateness of the queued items.
+         */
+    struct edf {
+      template<class T>
+      class container {
+      public:
+        void push(T &&t) {
+          _c.push_back(entry{std::move(t), _seq++});
+          std::push_heap(_c.begin(), _c.end(), later{});
+        }
+        T pop() {
+          std::pop_heap(_c.begin(), _c.end(), later{});
+          T t = std::move(_c.back().value);
+          _c.pop_back();
+          return t;
+        }
+        bool empty() const { return _c.empty(); }
+        std::size_t size() const { return _c.size(); }
+        void clear() { _c.clear(); }
+
+      private:
+        struct entry {
+          T value;
+          std::uint64_t seq;
+        };
+        struct later {
+          bool operator()(entry const &a, entry const &b) const {
+            return b.value.deadline < a.value.deadline || (!(a.value.deadline < b.value.deadline) && b.seq < a.seq);
+          }
+        };
+        std::vector<entry> _c{};
+        std::uint64_t _seq{0};
+      };
+    };
+
+    /**
+         * @brief first in, first out on a bounded lock-free ring,
+         * pool::ring_buffer of Capacity slots.
+         * @details The container is lock-free (`lock_free` is true), so
+         * threaded_message_queue pushes and pops without its mutex, which
+         * is only taken to park an idle consumer. Nothing is allocated
+         * after the construction; a producer facing a full ring yields
+         * until a slot is free.
+         */
+    template<std::size_t Capacity = 1024>
+    struct ring {
+      template<class T>
+      class container : public ring_buffer<T> {
+      public:
+        static constexpr bool lock_free = true;
+        container()
+            : ring_buffer<T>(Capacity) {}
+      };
+    };
+
+  } // namespace discipline
+
+  namespace detail {
+    // whether the container of a discipline is lock-free, by its `static constexpr bool lock_free`
+    template<class C, typename = void>
+    struct is_lock_free_container : std::false_type {};
+    template<class C>
+    struct is_lock_free_container<C, std::void_t<decltype(C::lock_free)>> : std::bool_constant<C::lock_free> {};
+  } // namespace detail
+
+  /**
+     * @brief a blocking queue between the producer threads and the
+     * worker threads of a thread pool.
+     * @tparam T the item type
+     * @tparam Discipline the item pop_front() takes, discipline::fifo,
+     * discipline::lifo, discipline::edf, or discipline::ring<> (lock-free)
+     */
+  template<class T, class Discipline = discipline::fifo>
   class threaded_message_queue {
   public:
     using locker = std::unique_lock<std::mutex>;
+    using container_type = typename Discipline::template container<T>;
+    static constexpr bool lock_free = detail::is_lock_free_container<container_type>::value;
+
     void emplace_back(T &&t) {
-      {
+      if constexpr (lock_free) {
+        while (!_data.try_push(std::move(t))) // full: wait for the consumers
+          std::this_thread::yield();
+        // pairs with park(): either we see a sleeper, or it sees the item
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_sleepers.load(std::memory_order_seq_cst) == 0) return;
         locker l_(_m);
-        _data.emplace_back(std::move(t));
+      } else {
+        locker l_(_m);
+        _data.push(std::move(t));
       }
       _cv.notify_one();
     }
-    // void push_back(T const &t) {
-    //     {
-    //         locker l_(_m);
-    //         _data.push_back(t);
-    //     }
-    //     _cv.notify_one();
-    // }
-    // void push_back_bad(T t) {
-    //     {
-    //         locker l(_m);
-    //         _data.push_back(std::move(t));
-    //     }
-    //     _cv.notify_one();
-    // }
 
+    // blocks until an item is queued, or the queue is cleared
     inline std::optional<T> pop_front() {
       std::optional<T> ret;
-      {
+      if constexpr (lock_free) {
+        for (;;) {
+          if (_abort.load(std::memory_order_acquire)) {
+            pool_debug("pop_front, aborting");
+            return ret; // std::nullopt;
+          }
+          if ((ret = _data.try_pop())) break;
+          park();
+        }
+        pool_debug("pop_front, got task");
+      } else {
         locker l_(_m);
         _cv.wait(l_, [this] { return _abort || !_data.empty(); });
         if (_abort) {
@@ -350,70 +540,186 @@ namespace ticker::pool {
           return ret; // std::nullopt;
         }
         pool_debug("pop_front, wake up and got task");
-        ret.emplace(std::move(_data.back()));
-        _data.pop_back();
+        ret.emplace(_data.pop());
       }
       std::this_thread::yield();
       return ret;
     }
-    // inline std::optional<T> pop_front_bad() {
-    //     locker l(_m);
-    //     _cv.wait(l, [this] { return _abort || !_data.empty(); });
-    //     if (_abort) return {}; // std::nullopt;
-    //
-    //     auto r = std::move(_data.back());
-    //     _data.pop_back();
-    //     return r;
-    // }
+    // pop_front(), or std::nullopt once d passed with nothing queued, see aborted()
+    std::optional<T> pop_front_for(std::chrono::nanoseconds d) {
+      std::optional<T> ret;
+      auto until = std::chrono::steady_clock::now() + d;
+      if constexpr (lock_free) {
+        for (;;) {
+          if (_abort.load(std::memory_order_acquire)) return ret;
+          if ((ret = _data.try_pop())) break;
+          if (!park_until(until)) return ret;
+        }
+      } else {
+        locker l_(_m);
+        if (!_cv.wait_until(l_, until, [this] { return _abort || !_data.empty(); }) || _abort)
+          return ret;
+        ret.emplace(_data.pop());
+      }
+      return ret;
+    }
+    // cleared, pop_front() returns std::nullopt from now on
+    bool aborted() const { return _abort.load(std::memory_order_acquire); }
 
     void clear() {
       {
         locker l_(_m);
         _abort = true;
-        _data.clear();
+        if constexpr (lock_free) {
+          while (_data.try_pop())
+            ;
+        } else {
+          _data.clear();
+        }
       }
       _cv.notify_all();
     }
     ~threaded_message_queue() { clear(); }
 
-    bool empty() const { return _data.empty(); }
+    bool empty() const {
+      if constexpr (lock_free) {
+        return _data.empty();
+      } else {
+        locker l_(_m);
+        return _data.empty();
+      }
+    }
+    std::size_t size() const {
+      if constexpr (lock_free) {
+        return _data.size();
+      } else {
+        locker l_(_m);
+        return _data.size();
+      }
+    }
+
+  private:
+    // the lock-free container: sleeps until an item may be there
+    void park() {
+      locker l_(_m);
+      _sleepers.fetch_add(1, std::memory_order_seq_cst);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      _cv.wait(l_, [this] { return _abort || !_data.empty(); });
+      _sleepers.fetch_sub(1, std::memory_order_relaxed);
+    }
+    // park() until a time point, returns false if it passed
+    bool park_until(std::chrono::steady_clock::time_point until) {
+      locker l_(_m);
+      _sleepers.fetch_add(1, std::memory_order_seq_cst);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      bool ret = _cv.wait_until(l_, until, [this] { return _abort || !_data.empty(); });
+      _sleepers.fetch_sub(1, std::memory_order_relaxed);
+      return ret;
+    }
 
   private:
     std::condition_variable _cv{};
-    std::mutex _m{};
-    mutable Coll _data{};
-    bool _abort = false;
+    mutable std::mutex _m{};
+    container_type _data{};
+    std::atomic<bool> _abort{false};
+    std::atomic<std::size_t> _sleepers{0}; // the consumers parked, of the lock-free container
   }; // class threaded_message_queue
 
+  /**
+     * @brief a task of thread_pool, with the time it's due to run.
+     */
+  struct pool_task {
+    task_fn fn;
+    deadline_t deadline;
+    void operator()() const { fn(); }
+  };
+
+  /**
+     * @brief the bounds and the triggers of an elastic thread pool.
+     */
+  struct elastic_options {
+    std::size_t min_workers{1};  // kept even when idle
+    std::size_t max_workers{std::max(1u, std::thread::hardware_concurrency())};
+    std::chrono::nanoseconds idle_timeout{std::chrono::seconds(60)}; // a worker above min_workers idle that long retires
+    std::chrono::nanoseconds grow_latency{std::chrono::milliseconds(5)}; // tasks waiting that long with no progress add a worker
+  };
+
   /**
      * @brief a c++11 thread pool with pre-created, fixed running threads and free tasks management.
      * 
-     * @par Each thread will try to lock the task queue and fetch the newest one for launching.
+     * @par Each thread will try to lock the task queue and fetch the next one for launching,
+     * picked by the Discipline: the oldest one (discipline::fifo, thread_pool), the newest one
+     * (discipline::lifo), or the one of the earliest deadline (discipline::edf).
+     * discipline::ring<> keeps the oldest first on a bounded lock-free ring instead, so posting
+     * takes no lock and allocates nothing.
+     * 
+     * @par An elastic pool, built with elastic_options, starts min_workers and adds one
+     * worker each time the queued tasks have waited grow_latency while no worker took any,
+     * up to max_workers. A worker idle for idle_timeout retires, down to min_workers. A
+     * supervisor thread watches the waits; it sleeps while nothing is queued.
+     * @code{c++}
+     * auto pool = std::make_shared<ticker::pool::thread_pool>(ticker::pool::elastic_options{1, 16});
+     * auto t = ticker::timer_t<>::get(pool);
+     * @endcode
      * 
      * @par This pool was inspired by one or two posts at stackoverflow, the original link needed.
      */
-  class thread_pool {
+  template<class Discipline = discipline::fifo>
+  class basic_thread_pool {
   public:
-    thread_pool(int n = 1u)
+    basic_thread_pool(int n = 1u)
 #if TICKER_CXX_ENABLE_THREAD_POOL_READY_SIGNAL
         : _cv_started((int) (n > 0 ? n : std::thread::hardware_concurrency()))
 #endif
     {
       start_thread((n > 0 ? n : std::thread::hardware_concurrency()));
     }
+    /**
+         * @param where the CPUs of the workers, see placement(); each
+         * worker pins itself when it starts.
+         */
+    basic_thread_pool(int n, pool::placement const &where)
+        : _where(where)
+        , _report(std::make_shared<placement_report>())
+#if TICKER_CXX_ENABLE_THREAD_POOL_READY_SIGNAL
+        , _cv_started((int) (n > 0 ? n : std::thread::hardware_concurrency()))
+#endif
+    {
+      _where->resolve();
+      start_thread((n > 0 ? n : std::thread::hardware_concurrency()));
+    }
+    explicit basic_thread_pool(elastic_options const &opts, std::optional<pool::placement> where = std::nullopt)
+        : _opts(opts)
+        , _elastic(true)
+        , _where(std::move(where))
+        , _report(_where ? std::make_shared<placement_report>() : nullptr)
+#if TICKER_CXX_ENABLE_THREAD_POOL_READY_SIGNAL
+        , _cv_started((int) std::max<std::size_t>(opts.min_workers, 1))
+#endif
+    {
+      _opts.min_workers = std::max<std::size_t>(_opts.min_workers, 1);
+      _opts.max_workers = std::max(_opts.max_workers, _opts.min_workers);
+      if (_where) _where->resolve();
+      start_thread(_opts.min_workers);
+      _supervisor = std::thread([this] { supervise(); });
+    }
     // thread_pool(thread_pool &&) = delete;
     // thread_pool &operator=(thread_pool &&) = delete;
-    CLAZZ_NON_COPYABLE(thread_pool);
-    ~thread_pool() { join(); }
+    CLAZZ_NON_COPYABLE(basic_thread_pool);
+    ~basic_thread_pool() { join(); }
 
   public:
+    /**
+         * @brief run task in the pool, for the callers who need its result.
+         * @return the future of the result, or of the exception thrown
+         */
     template<class F, class R = std::invoke_result_t<F>>
     std::future<R> queue_task(F &&task) {
       auto p = std::packaged_task<R()>(std::forward<F>(task));
       // std::packaged_task<R()> p(std::move(task));
       auto r = p.get_future();
       // _tasks.push_back(std::move(p));
-      _tasks.emplace_back(std::move(p));
+      post(std::move(p));
       pool_debug("queue_task.");
       std::this_thread::yield();
       return r;
@@ -424,55 +730,103 @@ namespace ticker::pool {
       // std::packaged_task<R()> p(std::move(task));
       auto r = p.get_future();
       // _tasks.push_back(std::move(p));
-      _tasks.emplace_back(std::move(p));
+      post(std::move(p));
       pool_debug("queue_task (copy).");
       std::this_thread::yield();
       return r;
     }
+    /**
+         * @brief run task in the pool and forget it, which makes
+         * thread_pool an executor, see pool::any_executor.
+         * @details Unlike queue_task() there is no std::packaged_task and
+         * no std::future, a small task is queued without any allocation.
+         * An exception escaping the task is logged and dropped.
+         */
+    template<class F>
+    void post(F &&task) { post(std::forward<F>(task), std::chrono::steady_clock::now()); }
+    /**
+         * @brief post a task which is due at deadline, such as a timer
+         * job due at its scheduled time, see discipline::edf.
+         */
+    template<class F>
+    void post(F &&task, deadline_t deadline) {
+      _tasks.emplace_back(pool_task{task_fn(std::forward<F>(task)), deadline});
+      if (_elastic && _idle.load() == 0)
+        stall_begin(false); // no worker is waiting for it
+    }
+    template<class F>
+    void execute(F &&task) { post(std::forward<F>(task)); }
     void join() { clear_threads(); }
     std::size_t active_threads() const { return _active; }
-    std::size_t total_threads() const { return _threads.size(); }
+    std::size_t total_threads() const { return _live; }
+    // the workers waiting for a task, of an elastic pool
+    std::size_t idle_threads() const { return _idle; }
+    bool elastic() const { return _elastic; }
+    /**
+         * @brief the CPUs the workers were pinned to, nullptr if the pool
+         * was built without a placement.
+         */
+    std::shared_ptr<placement_report> const &placement() const { return _report; }
+    elastic_options const &elasticity() const { return _opts; }
     auto &tasks() { return _tasks; }
     auto const &tasks() const { return _tasks; }
 
   private:
-    template<class F, class R = std::invoke_result_t<F>>
-    std::future<R> run_task(F &&task) {
-      if (active_threads() >= total_threads()) {
-        start_thread();
-      }
-      return queue_task(std::move(task));
-    }
     void clear_threads() {
+      if (_supervisor.joinable()) {
+        {
+          std::unique_lock<std::mutex> l(_m_sup);
+          _sup_stop = true;
+        }
+        _cv_sup.notify_all();
+        _supervisor.join();
+      }
       _tasks.clear();
       _future_ended.wait();
-      _threads.clear();
+      std::vector<std::future<void>> threads;
+      {
+        std::unique_lock<std::mutex> l(_m_threads);
+        threads.swap(_threads);
+      }
+      threads.clear(); // waits for the workers
     }
     void start_thread(std::size_t n = 1) {
+      std::unique_lock<std::mutex> l(_m_threads);
+      // the retired workers
+      _threads.erase(std::remove_if(_threads.begin(), _threads.end(), [](std::future<void> const &f) {
+                       return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+                     }),
+                     _threads.end());
       while (n-- > 0) {
+        ++_live;
+        std::size_t index = _spawned++;
         _threads.push_back(
             std::async(std::launch::async,
-                       [&
+                       [&, index
 #if TICKER_CXX_TEST_THREAD_POOL_DBGOUT
                         ,
                         n
 #endif
         ] {
                          cw_setter cws(_future_ended);
+                         if (_where)
+                           apply_placement(*_report, "worker " + std::to_string(index), _where->worker_cpus(index), *_where);
 #if TICKER_CXX_ENABLE_THREAD_POOL_READY_SIGNAL
                          _cv_started.set();
 #endif
 #if TICKER_CXX_TEST_THREAD_POOL_DBGOUT
                          pool_debug("  . pool.n = %lu..", n);
 #endif
-                         while (auto task = _tasks.pop_front()) {
+                         while (auto task = next_task()) {
                            pool_debug("got_task.");
                            ++_active;
                            try {
                              (*task)();
+                           } catch (std::exception const &e) {
+                             // from a posted task, a packaged one keeps it in the future
+                             dbg_print("[pool] a posted task threw: %s", e.what());
                            } catch (...) {
-                             --_active;
-                             throw;
+                             dbg_print("[pool] a posted task threw");
                            }
                            --_active;
                          }
@@ -486,15 +840,101 @@ namespace ticker::pool {
 #endif
     }
 
+    // the next task of a worker, std::nullopt when it exits
+    std::optional<pool_task> next_task() {
+      if (!_elastic) return _tasks.pop_front();
+      for (;;) {
+        ++_idle;
+        auto task = _tasks.pop_front_for(_opts.idle_timeout);
+        --_idle;
+        if (task) {
+          // progress: the window of the tasks still waiting restarts
+          if (!_tasks.empty()) {
+            stall_begin(true);
+          } else {
+            _stall_since.store(0);
+            if (!_tasks.empty()) stall_begin(false);
+          }
+          return task;
+        }
+        if (_tasks.aborted()) return task;
+        auto live = _live.load();
+        while (live > _opts.min_workers) {
+          if (_live.compare_exchange_weak(live, live - 1)) {
+            pool_debug("  . pool.retired, %zu workers left", live - 1);
+            return task;
+          }
+        }
+      }
+    }
+
+    static std::int64_t ticks() { return std::chrono::steady_clock::now().time_since_epoch().count(); }
+    // the tasks are waiting from now on: opens the window of the
+    // supervisor, or restarts it
+    void stall_begin(bool restart) {
+      std::int64_t old{0};
+      if (restart)
+        old = _stall_since.exchange(ticks());
+      else if (_stall_since.load(std::memory_order_relaxed) != 0 || !_stall_since.compare_exchange_strong(old, ticks()))
+        return;
+      if (old == 0 && _sup_parked.load()) {
+        std::unique_lock<std::mutex> l(_m_sup);
+        _cv_sup.notify_one();
+      }
+    }
+    // adds a worker when the queued tasks have waited grow_latency and no worker took any
+    void supervise() {
+      using steady = std::chrono::steady_clock;
+      std::unique_lock<std::mutex> l(_m_sup);
+      while (!_sup_stop) {
+        auto since = _stall_since.load();
+        if (since == 0) {
+          _sup_parked.store(true);
+          _cv_sup.wait(l, [this] { return _sup_stop || _stall_since.load() != 0; });
+          _sup_parked.store(false);
+          continue;
+        }
+        auto due = steady::time_point(steady::duration(since)) + std::chrono::duration_cast<steady::duration>(_opts.grow_latency);
+        if (steady::now() < due) {
+          _cv_sup.wait_until(l, due, [this] { return _sup_stop; });
+          continue;
+        }
+        if (_idle.load() == 0 && _live.load() < _opts.max_workers && !_tasks.empty()) {
+          pool_debug("  . pool.grow, %zu workers", _live.load() + 1);
+          start_thread(1);
+        }
+        // gives the new worker a window, and rechecks later
+        std::int64_t expected = since;
+        _stall_since.compare_exchange_strong(expected, ticks());
+      }
+    }
+
   private:
-    std::vector<std::future<void>> _threads{};                           // fixed, running pool
-    mutable threaded_message_queue<std::packaged_task<void()>> _tasks{}; // the futures
+    std::vector<std::future<void>> _threads{};                      // the running workers, and the retired ones not reaped yet
+    mutable threaded_message_queue<pool_task, Discipline> _tasks{}; // the packaged tasks, inline in task_fn
     std::atomic<std::size_t> _active{0};
+    std::atomic<std::size_t> _live{0}; // the workers not retired
+    elastic_options _opts{};
+    bool _elastic{false};
+    std::optional<pool::placement> _where{};
+    std::shared_ptr<placement_report> _report{};
+    std::size_t _spawned{0}; // the workers ever started, the index of the next one
+    std::mutex _m_threads{};
+    // of an elastic pool
+    std::atomic<std::size_t> _idle{0};
+    std::atomic<std::int64_t> _stall_since{0}; // the steady ticks since the queued tasks wait, 0 if none
+    std::atomic<bool> _sup_parked{false};
+    bool _sup_stop{false};
+    std::mutex _m_sup{};
+    std::condition_variable _cv_sup{};
+    std::thread _supervisor{};
 #if TICKER_CXX_ENABLE_THREAD_POOL_READY_SIGNAL
     conditional_wait_for_int _cv_started{};
 #endif
     conditional_wait_for_int _future_ended{};
-  }; // class thread_pool
+  }; // class basic_thread_pool
+
+  using thread_pool = basic_thread_pool<discipline::fifo>;
 
   class thread_pool_lite {
   public:
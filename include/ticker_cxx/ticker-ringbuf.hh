@@ -0,0 +1,137 @@
+// ticker_cxx Library
+// Copyright © 2021 Hedzr Yeh.
+//
+// This file is released under the terms of the MIT license.
+// Read /LICENSE for more information.
+
+//
+// Created by Hedzr Yeh on 2021/11/17.
+//
+
+#ifndef TICKER_CXX_TICKER_RINGBUF_HH
+#define TICKER_CXX_TICKER_RINGBUF_HH
+
+#include "ticker-def.hh"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <utility>
+
+namespace ticker::pool {
+
+  /**
+     * @brief a bounded lock-free multi-producer multi-consumer FIFO, the
+     * ring of Dmitry Vyukov.
+     * @details Each slot carries a sequence number: a producer claims
+     * the slot at the enqueue position when its sequence equals the
+     * position, a consumer the slot at the dequeue position when its
+     * sequence is one past it, by a CAS on the position. The slots and
+     * the two positions sit on their own cache lines, so the producers
+     * and the consumers don't share a line unless they hit the same
+     * slot. Nothing is allocated after the construction.
+     * @tparam T the item type, move constructible
+     */
+  template<typename T>
+  class ring_buffer {
+  public:
+    /**
+         * @param capacity rounded up to a power of two, at least 2
+         */
+    explicit ring_buffer(std::size_t capacity = 1024) {
+      std::size_t n = 2;
+      while (n < capacity) n <<= 1;
+      _slots.reset(new slot[n]);
+      _mask = n - 1;
+      for (std::size_t i = 0; i < n; ++i) _slots[i].seq.store(i, std::memory_order_relaxed);
+    }
+    ring_buffer(ring_buffer const &) = delete;
+    ring_buffer &operator=(ring_buffer const &) = delete;
+    ~ring_buffer() {
+      while (try_pop())
+        ;
+    }
+
+    /**
+         * @brief push an item, never blocks.
+         * @return false if the ring is full, v is left untouched then
+         */
+    bool try_push(T &&v) {
+      slot *s;
+      std::size_t pos = _enqueue.pos.load(std::memory_order_relaxed);
+      for (;;) {
+        s = &_slots[pos & _mask];
+        std::size_t seq = s->seq.load(std::memory_order_acquire);
+        auto dif = std::intptr_t(seq) - std::intptr_t(pos);
+        if (dif == 0) {
+          if (_enqueue.pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            break;
+        } else if (dif < 0) {
+          return false; // the slot of the last round is not consumed yet
+        } else {
+          pos = _enqueue.pos.load(std::memory_order_relaxed);
+        }
+      }
+      ::new (static_cast<void *>(s->storage)) T(std::move(v));
+      s->seq.store(pos + 1, std::memory_order_release);
+      return true;
+    }
+
+    /**
+         * @brief pop the oldest item, never blocks.
+         * @return std::nullopt if the ring is empty
+         */
+    std::optional<T> try_pop() {
+      slot *s;
+      std::size_t pos = _dequeue.pos.load(std::memory_order_relaxed);
+      for (;;) {
+        s = &_slots[pos & _mask];
+        std::size_t seq = s->seq.load(std::memory_order_acquire);
+        auto dif = std::intptr_t(seq) - std::intptr_t(pos + 1);
+        if (dif == 0) {
+          if (_dequeue.pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            break;
+        } else if (dif < 0) {
+          return std::nullopt; // not published yet
+        } else {
+          pos = _dequeue.pos.load(std::memory_order_relaxed);
+        }
+      }
+      T *p = std::launder(reinterpret_cast<T *>(s->storage));
+      std::optional<T> ret(std::move(*p));
+      p->~T();
+      s->seq.store(pos + _mask + 1, std::memory_order_release);
+      return ret;
+    }
+
+    // a snapshot, sequentially consistent, see threaded_message_queue
+    bool empty() const { return size() == 0; }
+    std::size_t size() const {
+      auto d = _dequeue.pos.load(std::memory_order_seq_cst);
+      auto e = _enqueue.pos.load(std::memory_order_seq_cst);
+      return e > d ? e - d : 0;
+    }
+    std::size_t capacity() const { return _mask + 1; }
+
+  private:
+    static constexpr std::size_t line = cross::hardware_destructive_interference_size;
+    struct alignas(line) slot {
+      std::atomic<std::size_t> seq{0};
+      alignas(T) unsigned char storage[sizeof(T)];
+    };
+    struct alignas(line) position {
+      std::atomic<std::size_t> pos{0};
+    };
+
+    position _enqueue{};
+    position _dequeue{};
+    std::unique_ptr<slot[]> _slots{};
+    std::size_t _mask{0};
+  }; // class ring_buffer
+
+} // namespace ticker::pool
+
+#endif //TICKER_CXX_TICKER_RINGBUF_HH
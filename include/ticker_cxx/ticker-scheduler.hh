@@ -0,0 +1,648 @@
+// ticker_cxx Library
+// Copyright © 2021 Hedzr Yeh.
+//
+// This file is released under the terms of the MIT license.
+// Read /LICENSE for more information.
+
+//
+// Created by Hedzr Yeh on 2021/11/11.
+//
+
+#ifndef TICKER_CXX_TICKER_SCHEDULER_HH
+#define TICKER_CXX_TICKER_SCHEDULER_HH
+
+#include "ticker-def.hh"
+
+#include "ticker-dbg.hh"
+#include "ticker-log.hh"
+#include "ticker-pool.hh"
+
+#include "ticker-affinity.hh"
+#include "ticker-chrono.hh"
+
+#include "ticker-executor.hh"
+#include "ticker-mpsc-inbox.hh"
+#include "ticker-slab.hh"
+#include "ticker-timer-handle.hh"
+#include "ticker-timer-job.hh"
+#include "ticker-timer-queue.hh"
+#include "ticker-wait-strategy.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <stdexcept>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// how long a stopping scheduler waits for its running interval jobs,
+// in milliseconds; the ones still running then are not added back
+#if !defined(TICKER_CXX_STOP_TIMEOUT_MS)
+#define TICKER_CXX_STOP_TIMEOUT_MS 5000
+#endif
+
+namespace ticker {
+
+  /**
+     * @brief the timer service behind timer_t, ticker_t and alarm_t: one
+     * timer queue, one runner thread and one worker pool.
+     * @details Each timer_t makes a private scheduler by default. Many
+     * front-ends can share one instead, so that 50 tickers take one
+     * runner plus a sized pool, not 50 runners plus 50 pools:
+     * @code{c++}
+     * auto s = ticker::scheduler<>::shared();
+     * auto t1 = ticker::timer_t<>::get(s);
+     * auto t2 = ticker::ticker_t<>::get(s);
+     * @endcode
+     * A front-end detaches on destruction, which cancels the jobs it
+     * scheduled. The scheduler stops when the last front-end holding it
+     * is gone.
+     *
+     * The jobs run on a pool::thread_pool of its own by default, or on
+     * any executor given, see pool::is_executor:
+     * @code{c++}
+     * auto t = ticker::timer_t<>::get(std::make_shared<ticker::pool::inline_executor>());
+     * @endcode
+     *
+     * The jobs made by the front-ends, and the buckets of a map_queue,
+     * are allocated from a pool::slab_arena of the scheduler, see
+     * arena() and allocator_stats().
+     * @tparam Clock
+     * @tparam QueuePolicy the storage of pending jobs, such as
+     * ticker::queue::map_policy or ticker::queue::wheel_policy&lt;>.
+     * @tparam Waiter the runner thread sleeps on it, pool::timer_killer
+     * (a condition variable) by default, or pool::timerfd_waiter on Linux.
+     * @tparam JobType the jobs it holds, basic_timer_job by default so
+     * that any job kinds can be mixed; a concrete job type makes the
+     * runner dispatch statically, see ticker::static_job.
+     */
+  template<typename Clock = Clock,
+           typename QueuePolicy = queue::map_policy,
+           typename Waiter = pool::timer_killer,
+           typename JobType = basic_timer_job<Clock>>
+  class scheduler {
+    static_assert(std::is_base_of_v<basic_timer_job<Clock>, JobType>, "scheduler: JobType must be a basic_timer_job of the Clock");
+
+  public:
+    using Job = JobType;
+    using _J = std::shared_ptr<Job>;
+    using TP = std::chrono::time_point<Clock>;
+    using Jobs = std::vector<_J>;
+    using TimingWheel = typename QueuePolicy::template queue_t<Clock, _J>;
+    using PastJobs = std::vector<std::pair<TP, _J>>;
+    using Inbox = queue::mpsc_inbox<std::pair<TP, _J>>;
+    // the due + slack of a slacked job, kept as a heap with the earliest on top
+    struct slack_deadline {
+      TP deadline;
+      std::size_t hits;       // of the job when added, it's launched since if they differ
+      std::weak_ptr<Job> job; // not holding it: a fired or cancelled job goes as usual
+      bool operator>(slack_deadline const &o) const { return o.deadline < deadline; }
+    };
+    using SlackDeadlines = std::vector<slack_deadline>;
+
+    /**
+         * @param workers the threads of the worker pool, zero or less
+         * for std::thread::hardware_concurrency().
+         */
+    explicit scheduler(int workers = -1)
+        : _exec(std::make_shared<pool::thread_pool>(workers)) { start(); }
+    /**
+         * @param e the executor to run the jobs on, it should keep
+         * running the posted jobs until the scheduler is destroyed.
+         */
+    template<typename Executor, typename = std::enable_if_t<pool::is_executor_v<Executor>>>
+    explicit scheduler(std::shared_ptr<Executor> e)
+        : _exec(std::move(e)) { start(); }
+    /**
+         * @brief a scheduler whose runner and workers are pinned by where,
+         * such as one scheduler per NUMA node:
+         * @code{c++}
+         * ticker::pool::placement where;
+         * where.node = 1;
+         * auto s = std::make_shared<ticker::scheduler<>>(8, where);
+         * printf("%s", s->placement()->to_string().c_str());
+         * @endcode
+         * @param workers the threads of the worker pool, see scheduler(int)
+         */
+    scheduler(int workers, pool::placement const &where)
+        : _where(where) {
+      _where->resolve();
+      auto p = std::make_shared<pool::thread_pool>(workers, *_where);
+      _placement = p->placement();
+      _exec = pool::any_executor(std::move(p));
+      start();
+    }
+    scheduler(scheduler const &) = delete;
+    scheduler &operator=(scheduler const &) = delete;
+    ~scheduler() {
+      dbg_debug("[scheduler] dtor...");
+      stop();
+    }
+
+    /**
+         * @brief the process-wide scheduler of this Clock, QueuePolicy
+         * and Waiter. It's made by the first call, and stopped once no
+         * front-end holds it any more.
+         * @param workers the worker threads if it's made by this call
+         */
+    static std::shared_ptr<scheduler> shared(int workers = -1) {
+      static std::mutex m;
+      static std::weak_ptr<scheduler> instance;
+      std::unique_lock<std::mutex> l(m);
+      auto s = instance.lock();
+      if (!s) instance = s = std::make_shared<scheduler>(workers);
+      return s;
+    }
+
+    detail::job_registry &registry() { return _registry; }
+    detail::job_registry const &registry() const { return _registry; }
+
+    /**
+         * @brief the slab arena of the jobs, see make_job().
+         */
+    std::shared_ptr<pool::slab_arena> const &arena() const { return _arena; }
+    /**
+         * @brief make a job of type J in the slab arena of the scheduler,
+         * the control block of the std::shared_ptr goes in the same block.
+         * @details For an intrusive QueuePolicy it's a hooked_job<J>.
+         */
+    template<typename J, typename... Args>
+    std::shared_ptr<J> make_job(Args &&...args) {
+      using M = std::conditional_t<detail::is_hooked<QueuePolicy>::value, hooked_job<J>, J>;
+      return std::allocate_shared<M>(pool::slab_allocator<M>(_arena), std::forward<Args>(args)...);
+    }
+    /**
+         * @brief the counters of the slab arena
+         */
+    pool::slab_stats allocator_stats() const { return _arena->stats(); }
+    /**
+         * @brief the CPUs the runner and the workers were pinned to,
+         * nullptr if the scheduler was built without a placement.
+         */
+    std::shared_ptr<pool::placement_report> const &placement() const { return _placement; }
+
+    /**
+         * @brief cancels the pending jobs of a front-end.
+         * @details The cancelled jobs are dropped by the runner when
+         * they are due. A job running in the pool already completes.
+         * @return the count of the jobs cancelled
+         */
+    std::size_t detach(detail::job_owner &owner) { return _registry.cancel_all(owner); }
+
+    // lock-free: the job is pushed into _inbox, and the runner moves it
+    // into _twl at its next iteration.
+    std::size_t add(TP const &tp, _J &&task) {
+      check_hooked(*task);
+      std::size_t size = ++_size;
+      auto deadline = tp + std::chrono::duration_cast<typename Clock::duration>(task->slack());
+      task->due(tp);
+      _inbox.push({tp, std::move(task)});
+      pool_debug("add_task. pool.size=%lu", size);
+      if (deadline < _wake_tp.load())
+        kick_runner(); // the runner is sleeping toward a later time point
+      return size;
+    }
+    // merges a batch of jobs, sorted by time point, in one critical section;
+    // the slacked ones go to their own queue as add() does
+    void add_sorted(typename TimingWheel::items_t &&items) {
+      if (items.empty()) return;
+      TP earliest = items.front().first;
+      for (auto &it : items) check_hooked(*it.second), it.second->due(it.first);
+      _size += items.size();
+      {
+        std::unique_lock<std::mutex> l(_l_twl);
+        drain_inbox_locked(); // the jobs added before go first
+        auto slacked = std::stable_partition(items.begin(), items.end(), [](auto const &it) { return it.second->slack() <= std::chrono::nanoseconds::zero(); });
+        for (auto it = slacked; it != items.end(); ++it) add_locked(it->first, std::move(it->second));
+        items.erase(slacked, items.end());
+        _twl.add_sorted(std::move(items));
+      }
+      if (earliest < _wake_tp.load())
+        kick_runner();
+    }
+    std::size_t remove(TP const &tp, _J const &task) {
+      std::size_t size;
+      {
+        std::unique_lock<std::mutex> l(_l_twl);
+        drain_inbox_locked();
+        auto &q = task->slack() > std::chrono::nanoseconds::zero() ? _slacked : _twl;
+        auto before = q.size();
+        q.remove(tp, task);
+        _size -= before - q.size();
+        size = _size;
+        if (&q == &_slacked && q.size() < before) {
+          auto it = std::remove_if(_slack_deadlines.begin(), _slack_deadlines.end(),
+                                   [&task](slack_deadline const &e) { return e.job.lock() == task; });
+          if (it != _slack_deadlines.end()) {
+            _slack_deadlines.erase(it, _slack_deadlines.end());
+            std::make_heap(_slack_deadlines.begin(), _slack_deadlines.end(), std::greater<>());
+          }
+        }
+      }
+      _registry.release(*task);
+      return size;
+    }
+
+    /**
+         * @brief keep the last n fired one-shot jobs for debugging.
+         * @details The history is off (n = 0) by default. A kept job is
+         * not released until it is pushed out of the ring.
+         */
+    void keep_history(std::size_t n) {
+      std::unique_lock<std::mutex> l(_l_pasts);
+      PastJobs tmp;
+      for (auto &it : history_locked()) tmp.emplace_back(std::move(it));
+      if (tmp.size() > n) tmp.erase(tmp.begin(), tmp.begin() + (std::ptrdiff_t) (tmp.size() - n));
+      _pasts.swap(tmp);
+      _pasts_capacity = n;
+      _pasts_head = n > 0 ? _pasts.size() % n : 0;
+    }
+    /**
+         * @brief the fired one-shot jobs kept by keep_history(), the oldest first.
+         */
+    PastJobs history() const {
+      std::unique_lock<std::mutex> l(_l_pasts);
+      return history_locked();
+    }
+
+    /**
+         * @brief choose how the runner thread waits for the deadlines.
+         * @param spin_window the spin before a deadline of
+         * pool::wait_strategy::spin_then_park, zero to calibrate it by
+         * pool::calibrate_park_latency().
+         */
+    void wait_strategy(pool::wait_strategy s, std::chrono::nanoseconds spin_window = std::chrono::nanoseconds::zero()) {
+      if (s == pool::wait_strategy::spin_then_park && spin_window <= std::chrono::nanoseconds::zero())
+        spin_window = pool::calibrate_park_latency();
+      _spin_window.store(spin_window);
+      _strategy.store(s);
+      kick_runner(); // takes effect from the next wait
+    }
+    pool::wait_strategy wait_strategy() const { return _strategy.load(); }
+    std::chrono::nanoseconds spin_window() const { return _spin_window.load(); }
+    /**
+         * @brief the runner wakeups which fired jobs
+         */
+    std::size_t wakeups() const { return _wakeups.load(std::memory_order_relaxed); }
+    /**
+         * @brief the runner wakeups which fired slacked jobs ahead of
+         * their own deadlines, merging their windows with an earlier one
+         * instead of taking wakeups of their own.
+         */
+    std::size_t coalesced_wakeups() const { return _coalesced.load(std::memory_order_relaxed); }
+    /**
+         * @brief the pending jobs, including the cancelled ones which
+         * are not due yet.
+         */
+    std::size_t size() const { return _size.load(); }
+
+  private:
+    // launches a due job, or drops it if it's cancelled; a recurring
+    // one goes into recurred_jobs to be added back
+    void launch(std::shared_ptr<Job> &j, Jobs &recurred_jobs) {
+      if (j->cancelled()) {
+        // cancelled by its handle, drop it lazily
+        j.reset();
+      } else if constexpr (detail::is_one_shot<Job>::value) {
+        if (_registry.release(*j))
+          j->launch_to(_exec);
+        else
+          j.reset(); // a cancel() took the handle first
+      } else if (j->_interval) {
+        // pool_debug("[runner] job starting, _interval");
+        _in_flight->enter();
+        try {
+          j->launch_to(_exec, [this, flight = _in_flight](basic_timer_job<Clock> *tj) {
+            std::lock_guard<std::mutex> l(flight->m);
+            if (!flight->closed && !tj->cancelled())
+              add(next_of(*static_cast<Job *>(tj)), std::static_pointer_cast<Job>(tj->shared_from_this()));
+            flight->leave_locked();
+          });
+        } catch (...) {
+          _in_flight->leave(); // no post-job will run
+          throw;
+        }
+      } else if (j->_recur) {
+        // pool_debug("[runner] job starting, _recur");
+        j->launch_to(_exec);
+        recurred_jobs.emplace_back(std::move(j));
+      } else {
+        // pool_debug("[runner] job starting");
+        if (_registry.release(*j))
+          j->launch_to(_exec);
+        else
+          j.reset(); // a cancel() took the handle first
+      }
+    }
+    // a job the executor rejected: its handle goes stale, as if it fired
+    void drop(std::shared_ptr<Job> &j) {
+      if (!j) return;
+      _registry.release(*j);
+      j.reset();
+    }
+    // an intrusive queue links the jobs through their hooks, they must be made by make_job()
+    static void check_hooked([[maybe_unused]] Job &j) {
+      if constexpr (detail::is_hooked<QueuePolicy>::value)
+        if (!j.queue_hook()) throw std::invalid_argument("scheduler: a job of an intrusive QueuePolicy must be a hooked_job, see make_job()");
+    }
+    // the interval jobs posted but not added back yet. Their post-jobs
+    // hold it, so that one still running after stop() gave up waiting
+    // sees it closed instead of a destroyed scheduler.
+    struct in_flight {
+      std::mutex m{};
+      std::condition_variable cv{};
+      std::size_t count{0};
+      bool closed{false};
+
+      void enter() {
+        std::lock_guard<std::mutex> l(m);
+        ++count;
+      }
+      void leave() {
+        std::lock_guard<std::mutex> l(m);
+        leave_locked();
+      }
+      void leave_locked() {
+        if (--count == 0) cv.notify_all();
+      }
+      // waits up to d for count to drop to zero, then closes; returns the count left
+      template<typename Duration>
+      std::size_t close(Duration const &d) {
+        std::unique_lock<std::mutex> l(m);
+        cv.wait_for(l, d, [this] { return count == 0; });
+        closed = true;
+        return count;
+      }
+    };
+
+    PastJobs history_locked() const {
+      PastJobs ret;
+      if (_pasts.size() < _pasts_capacity) return _pasts;
+      for (std::size_t i = 0; i < _pasts.size(); ++i)
+        ret.emplace_back(_pasts[(_pasts_head + i) % _pasts.size()]);
+      return ret;
+    }
+    void stop() {
+      dbg_debug("[runner] stopping...");
+      _t.detach();
+      _stopping.store(true);
+      _tk.kill();
+      // if (_t.joinable()) _t.join();
+      _ended.wait();
+      // the interval jobs running add() themselves back when they end;
+      // a late one finds it closed, and leaves this scheduler alone
+      if (auto left = _in_flight->close(std::chrono::milliseconds(TICKER_CXX_STOP_TIMEOUT_MS)))
+        dbg_print("[runner] stopped with %zu interval jobs running, they will not recur", left);
+      dbg_debug("[runner] stopped.");
+    }
+    void start() {
+      {
+        std::unique_lock<std::mutex> l(_l_twl);
+        dbg_trace("[runner] starting...");
+      }
+      _t = std::thread(runner, this);
+      _started.wait();
+      // t.detach();
+      dbg_trace("[runner] started.");
+    }
+
+    static void runner(scheduler *_this) { _this->runner_loop(); }
+    void runner_loop() {
+      bool ret;
+      using namespace std::literals::chrono_literals;
+      const auto starting_gap = 10ns;
+      std::chrono::nanoseconds d = starting_gap;
+      TP wake = Clock::now() + std::chrono::duration_cast<typename Clock::duration>(d);
+#if defined(_DEBUG) || TICKER_CXX_TEST_THREAD_POOL_DBGOUT
+      std::size_t hit{0}, loop{0};
+#endif
+      if (_where)
+        pool::apply_placement(*_placement, "runner", _where->runner_cpus(), *_where);
+      _started.set();
+      dbg_trace("[runner] ready...");
+      while ((ret = wait_next(wake)) != _tk.ConditionMatched) {
+        // std::this_thread::sleep_for(d);
+        dbg_debug("[runner] waked up. (_tk.terminated() == %d, ret=%d)", _tk.terminated(), ret);
+
+        _wake_tp.store(TP::min()); // awake, add() needn't kick us
+        TP picked = Clock::now(), next_tp;
+        Jobs &jobs = _fired, &recurred_jobs = _recurred; // reused, they keep their capacities
+        jobs.clear(), recurred_jobs.clear();
+        bool found;
+        {
+          std::unique_lock<std::mutex> l(_l_twl);
+          drain_inbox_locked();
+          found = _twl.pop_expired(picked, jobs);
+          auto from = jobs.size();
+          if (_slacked.pop_expired(picked, jobs)) {
+            found = true;
+            auto early = [&picked](_J const &j) {
+              return !j->cancelled() && picked < j->due() + std::chrono::duration_cast<typename Clock::duration>(j->slack());
+            };
+            if (std::any_of(jobs.begin() + std::ptrdiff_t(from), jobs.end(), early))
+              _coalesced.fetch_add(1, std::memory_order_relaxed);
+          }
+        }
+        _size -= jobs.size();
+
+        if (found) {
+          _wakeups.fetch_add(1, std::memory_order_relaxed);
+          dbg_debug("[runner] found a time-point");
+#if defined(_DEBUG) || TICKER_CXX_TEST_THREAD_POOL_DBGOUT
+          if ((hit % 10) == 0)
+            pool_debug("[runner] [hit: %u, loop: %u] picked = %s, %u jobs",
+                       hit, loop, chrono::format_time_point(picked).c_str(), jobs.size());
+          hit++;
+#endif
+
+          // launch the jobs, each pool task holds a reference to its job
+          for (auto it = jobs.begin(); it != jobs.end(); ++it) {
+            std::shared_ptr<Job> &j = (*it);
+            try {
+              launch(j, recurred_jobs);
+            } catch (std::exception const &e) {
+              // rejected by the executor, such as a stopped pool: the runner goes on
+              dbg_print("[runner] a job was not launched, dropped: %s", e.what());
+              drop(j);
+            } catch (...) {
+              dbg_print("[runner] a job was not launched, dropped");
+              drop(j);
+            }
+          }
+
+          record_history(picked, jobs);
+
+          for (auto &j : recurred_jobs) {
+            auto tp = next_of(*j);
+#if defined(_DEBUG) || TICKER_CXX_TEST_THREAD_POOL_DBGOUT
+            auto size = add(tp, std::move(j));
+            if ((loop % 10) == 0)
+              pool_debug("[runner] [size: %u, hit: %u, loop: %u] _recur job/%d added: %s",
+                         size, hit, loop, recurred_jobs.size(),
+                         chrono::format_time_point(tp).c_str());
+            UNUSED(size);
+            loop++;
+#else
+            add(tp, std::move(j));
+#endif
+          }
+          jobs.clear(), recurred_jobs.clear(); // drops the references held
+        } else {
+          dbg_debug("[runner] pop_expired() returned nothing");
+        }
+
+        // sleep toward the earliest deadline; an earlier one added
+        // later by add() will kick us up. Publishing _wake_tp then
+        // re-checking the inbox pairs with add(), which pushes then
+        // reads _wake_tp: a job is never left unseen.
+        {
+          std::unique_lock<std::mutex> l(_l_twl);
+          do {
+            _wake_tp.store(TP::min());
+            drain_inbox_locked();
+            auto now = Clock::now();
+            d = _larger_gap;
+            if (next_deadline_locked(next_tp))
+              d = next_gap(next_tp, now);
+            wake = now + std::chrono::duration_cast<typename Clock::duration>(d);
+            _wake_tp.store(wake);
+          } while (!_inbox.empty());
+        }
+      }
+      dbg_debug("[runner] scheduler::runner ended (_tk.terminated() == %d, ret = %d).", _tk.terminated(), ret);
+      _ended.set();
+    }
+    // sleeps toward wake by the wait strategy, returns true if killed
+    bool wait_next(TP const &wake) {
+      auto strategy = _strategy.load(std::memory_order_relaxed);
+      if (strategy == pool::wait_strategy::park)
+        return _tk.wait_until_or_kick(wake);
+
+      if (strategy == pool::wait_strategy::spin_then_park) {
+        auto spin_from = wake - std::chrono::duration_cast<typename Clock::duration>(_spin_window.load(std::memory_order_relaxed));
+        if (Clock::now() < spin_from) {
+          if (_tk.wait_until_or_kick(spin_from)) return true;
+          if (Clock::now() < spin_from) return false; // kicked
+        }
+      }
+      while (Clock::now() < wake && !_poked.exchange(false, std::memory_order_acquire) && !_stopping.load(std::memory_order_relaxed))
+        pool::cpu_relax();
+      return _stopping.load();
+    }
+    void kick_runner() {
+      _poked.store(true, std::memory_order_release); // breaks a spinning runner
+      _tk.kick();
+    }
+    // moves a recurring job on to its next firing: the advance() of a
+    // concrete Job is called by its qualified name, which is not virtual
+    // and can be inlined, basic_timer_job calls it virtually
+    static TP next_of(Job &j) {
+      if constexpr (std::is_same_v<Job, basic_timer_job<Clock>>)
+        return j.advance(Clock::now());
+      else
+        return j.Job::advance(Clock::now());
+    }
+    // moves the jobs pushed by add() into _twl, or _slacked
+    void drain_inbox_locked() {
+      _inbox.drain([this](std::pair<TP, _J> &&it) { add_locked(it.first, std::move(it.second)); });
+    }
+    // a slacked job goes to _slacked, with its deadline
+    void add_locked(TP const &tp, _J &&j) {
+      auto slack = j->slack();
+      if (slack <= std::chrono::nanoseconds::zero()) {
+        _twl.add(tp, std::move(j));
+      } else {
+        _slack_deadlines.push_back({tp + std::chrono::duration_cast<typename Clock::duration>(slack), j->hits(), j});
+        std::push_heap(_slack_deadlines.begin(), _slack_deadlines.end(), std::greater<>());
+        _slacked.add(tp, std::move(j));
+      }
+    }
+    // the time point the runner must wake up at: the earliest due of
+    // the exact jobs, or the earliest due + slack of the slacked ones.
+    // The deadlines on top whose jobs have been launched, gone or
+    // cancelled since are purged.
+    bool next_deadline_locked(TP &tp) {
+      auto stale = [](slack_deadline const &e) {
+        auto j = e.job.lock();
+        return !j || j->cancelled() || j->hits() != e.hits;
+      };
+      while (!_slack_deadlines.empty() && stale(_slack_deadlines.front())) {
+        std::pop_heap(_slack_deadlines.begin(), _slack_deadlines.end(), std::greater<>());
+        _slack_deadlines.pop_back();
+      }
+      bool found = _twl.next_time_point(tp);
+      if (!_slack_deadlines.empty() && (!found || _slack_deadlines.front().deadline < tp))
+        tp = _slack_deadlines.front().deadline, found = true;
+      return found;
+    }
+    // keeps the one-shot jobs launched; a recurring one is not pinned here while queued
+    void record_history(TP const &picked, Jobs const &jobs) {
+      std::unique_lock<std::mutex> l(_l_pasts);
+      if (_pasts_capacity == 0) return;
+      for (auto &j : jobs) {
+        if (!j || j->_recur || j->_interval) continue; // dropped, or to be added back
+        if (_pasts.size() < _pasts_capacity)
+          _pasts.emplace_back(picked, j);
+        else
+          _pasts[_pasts_head] = {picked, j};
+        _pasts_head = (_pasts_head + 1) % _pasts_capacity;
+      }
+    }
+    // how long the runner sleeps for waiting for tp
+    std::chrono::nanoseconds next_gap(TP const &tp, TP const &now) const {
+      std::chrono::nanoseconds d = tp - now;
+      if (d > _larger_gap)
+        d = _larger_gap;
+      else if (d > _wastage)
+        d -= _wastage;
+      else if (d < std::chrono::nanoseconds::zero())
+        d = std::chrono::nanoseconds::zero();
+      return d;
+    }
+
+    // the queues which take an arena share the one of the scheduler
+    TimingWheel make_queue() const {
+      if constexpr (std::is_constructible_v<TimingWheel, std::shared_ptr<pool::slab_arena>>)
+        return TimingWheel(_arena);
+      else
+        return TimingWheel();
+    }
+
+  private:
+    std::shared_ptr<pool::slab_arena> _arena{std::make_shared<pool::slab_arena>()};
+    detail::job_registry _registry{}; // outlives _twl, the registered jobs are owned by it
+    std::thread _t;
+    Waiter _tk{}; // to shut down the sleep+loop in `runner` thread gracefully
+    TimingWheel _twl = make_queue();
+    TimingWheel _slacked = make_queue(); // the jobs with slack windows, see timer_t::slack()
+    Jobs _fired{}, _recurred{};          // the jobs popped by the runner loop
+    SlackDeadlines _slack_deadlines{}; // of the jobs in _slacked
+    std::atomic<std::size_t> _wakeups{0}, _coalesced{0};
+    Inbox _inbox{};                    // the jobs added but not moved into _twl yet
+    std::atomic<std::size_t> _size{0}; // the pending jobs in _inbox and _twl
+    PastJobs _pasts{}; // a bounded ring of the fired jobs, see keep_history()
+    std::size_t _pasts_capacity{0}, _pasts_head{0};
+    mutable std::mutex _l_pasts{};
+    std::atomic<TP> _wake_tp{TP::min()}; // the time point the runner is sleeping toward
+    std::atomic<pool::wait_strategy> _strategy{pool::wait_strategy::park};
+    std::atomic<std::chrono::nanoseconds> _spin_window{std::chrono::nanoseconds::zero()};
+    std::atomic<bool> _poked{false}, _stopping{false};
+    std::mutex _l_twl{};
+    pool::any_executor _exec;                // a pool::thread_pool of its own by default
+    std::optional<pool::placement> _where{}; // of the runner, and of the workers of its own pool
+    std::shared_ptr<pool::placement_report> _placement{};
+    std::shared_ptr<in_flight> _in_flight{std::make_shared<in_flight>()};
+    pool::conditional_wait_for_bool _started{}, _ended{};                   // runner thread terminated.
+    std::chrono::nanoseconds _larger_gap = std::chrono::milliseconds(3000); // = 3s
+    std::chrono::nanoseconds _wastage = std::chrono::milliseconds(0);
+  }; // class scheduler
+
+} // namespace ticker
+
+#endif //TICKER_CXX_TICKER_SCHEDULER_HH
@@ -0,0 +1,177 @@
+// ticker_cxx Library
+// Copyright © 2021 Hedzr Yeh.
+//
+// This file is released under the terms of the MIT license.
+// Read /LICENSE for more information.
+
+//
+// Created by Hedzr Yeh on 2021/11/14.
+//
+
+#ifndef TICKER_CXX_TICKER_SLAB_HH
+#define TICKER_CXX_TICKER_SLAB_HH
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+// the largest block served by a slab_arena, in bytes; the larger ones
+// go to the global heap
+#if !defined(TICKER_CXX_SLAB_MAX_BLOCK)
+#define TICKER_CXX_SLAB_MAX_BLOCK 512
+#endif
+
+namespace ticker::pool {
+
+  /**
+     * @brief the counters of a slab_arena.
+     */
+  struct slab_stats {
+    std::size_t allocations{};   // the blocks handed out, including the heap fallbacks
+    std::size_t deallocations{}; // the blocks given back
+    std::size_t hits{};          // the allocations served by a free list without a new chunk
+    std::size_t fallbacks{};     // the allocations too large or too aligned, served by the heap
+    std::size_t chunks{};        // the chunks carved so far
+    std::size_t reserved{};      // the bytes of all chunks
+    std::size_t in_use{};        // the blocks handed out but not given back yet
+  };
+
+  /**
+     * @brief a thread-safe pool of fixed-size blocks, one free list per
+     * size class.
+     * @details The blocks are carved out of chunks of about 4KB, and a
+     * freed block goes back to the head of its free list, so the next
+     * allocation of that size reuses the memory just touched. The chunks
+     * are kept until the arena is destroyed.
+     *
+     * The size classes are the multiples of alignof(std::max_align_t)
+     * up to TICKER_CXX_SLAB_MAX_BLOCK (512) bytes, a larger or
+     * over-aligned request falls back to the global operator new.
+     */
+  class slab_arena {
+  public:
+    static constexpr std::size_t granule = alignof(std::max_align_t);
+    static constexpr std::size_t max_block = (TICKER_CXX_SLAB_MAX_BLOCK + granule - 1) / granule * granule;
+    static constexpr std::size_t chunk_size = 4096;
+
+    slab_arena() = default;
+    slab_arena(slab_arena const &) = delete;
+    slab_arena &operator=(slab_arena const &) = delete;
+    ~slab_arena() {
+      for (auto *c : _chunks) ::operator delete(c);
+    }
+
+    void *allocate(std::size_t n, std::size_t align = granule) {
+      if (n == 0) n = 1;
+      std::unique_lock<std::mutex> l(_m);
+      _stats.allocations++, _stats.in_use++;
+      if (n > max_block || align > granule) {
+        _stats.fallbacks++;
+        l.unlock();
+        return ::operator new(n);
+      }
+      auto &head = _free[n / granule - (n % granule == 0)];
+      if (head)
+        _stats.hits++;
+      else
+        head = carve((n + granule - 1) / granule * granule);
+      auto *b = head;
+      head = b->next;
+      return b;
+    }
+    void deallocate(void *p, std::size_t n, std::size_t align = granule) noexcept {
+      if (!p) return;
+      if (n == 0) n = 1;
+      std::unique_lock<std::mutex> l(_m);
+      _stats.deallocations++, _stats.in_use--;
+      if (n > max_block || align > granule) {
+        l.unlock();
+        ::operator delete(p);
+        return;
+      }
+      auto &head = _free[n / granule - (n % granule == 0)];
+      head = ::new (p) block{head};
+    }
+
+    slab_stats stats() const {
+      std::unique_lock<std::mutex> l(_m);
+      return _stats;
+    }
+
+  private:
+    struct block {
+      block *next;
+    };
+    // a new chunk of blocks of size bytes, linked up in address order
+    block *carve(std::size_t size) {
+      std::size_t count = chunk_size / size;
+      if (count < 8) count = 8;
+      _chunks.reserve(_chunks.size() + 1);
+      auto *c = static_cast<unsigned char *>(::operator new(count * size));
+      _chunks.push_back(c);
+      _stats.chunks++, _stats.reserved += count * size;
+      block *head = nullptr;
+      for (std::size_t i = count; i-- > 0;)
+        head = ::new (static_cast<void *>(c + i * size)) block{head};
+      return head;
+    }
+
+  private:
+    mutable std::mutex _m{};
+    block *_free[max_block / granule]{};
+    std::vector<unsigned char *> _chunks{};
+    slab_stats _stats{};
+  }; // class slab_arena
+
+  /**
+     * @brief a standard allocator on a shared slab_arena.
+     * @details Each copy holds the arena, so the memory stays valid as
+     * long as any object allocated from it, even if the scheduler which
+     * made the arena is gone. Without an arena it falls back to the
+     * global heap.
+     * @code{c++}
+     * auto arena = std::make_shared<ticker::pool::slab_arena>();
+     * auto j = std::allocate_shared<job>(ticker::pool::slab_allocator<job>(arena), ...);
+     * @endcode
+     */
+  template<typename T>
+  class slab_allocator {
+  public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    slab_allocator() noexcept = default;
+    explicit slab_allocator(std::shared_ptr<slab_arena> a) noexcept
+        : _a(std::move(a)) {}
+    template<typename U>
+    slab_allocator(slab_allocator<U> const &o) noexcept
+        : _a(o.arena()) {}
+
+    T *allocate(std::size_t n) {
+      if (!_a) return static_cast<T *>(::operator new(n * sizeof(T)));
+      return static_cast<T *>(_a->allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T *p, std::size_t n) noexcept {
+      if (!_a) return ::operator delete(p);
+      _a->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    std::shared_ptr<slab_arena> const &arena() const noexcept { return _a; }
+
+    template<typename U>
+    bool operator==(slab_allocator<U> const &o) const noexcept { return _a == o.arena(); }
+    template<typename U>
+    bool operator!=(slab_allocator<U> const &o) const noexcept { return _a != o.arena(); }
+
+  private:
+    std::shared_ptr<slab_arena> _a{};
+  }; // class slab_allocator
+
+} // namespace ticker::pool
+
+#endif //TICKER_CXX_TICKER_SLAB_HH
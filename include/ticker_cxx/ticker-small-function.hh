@@ -0,0 +1,142 @@
+// ticker_cxx Library
+// Copyright © 2021 Hedzr Yeh.
+//
+// This file is released under the terms of the MIT license.
+// Read /LICENSE for more information.
+
+//
+// Created by Hedzr Yeh on 2021/11/13.
+//
+
+#ifndef TICKER_CXX_TICKER_SMALL_FUNCTION_HH
+#define TICKER_CXX_TICKER_SMALL_FUNCTION_HH
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// the inline buffer of util::small_function, in bytes
+#if !defined(TICKER_CXX_SMALL_FUNCTION_SIZE)
+#define TICKER_CXX_SMALL_FUNCTION_SIZE 48
+#endif
+
+namespace ticker::util {
+
+  template<typename Sig, std::size_t Size = TICKER_CXX_SMALL_FUNCTION_SIZE>
+  class small_function;
+
+  namespace detail {
+    template<typename T>
+    struct is_std_function : std::false_type {};
+    template<typename Sig>
+    struct is_std_function<std::function<Sig>> : std::true_type {};
+    template<typename Sig, std::size_t Size>
+    struct is_std_function<small_function<Sig, Size>> : std::true_type {};
+  } // namespace detail
+
+  /**
+     * @brief a move-only std::function with an inline buffer.
+     * @details A callable up to Size bytes (and nothrow movable) is kept
+     * in the buffer, so the common captures, a few pointers and a
+     * std::shared_ptr, never touch the heap. A larger one is allocated
+     * as std::function does. Being move-only, it holds the move-only
+     * callables too, such as a std::packaged_task.
+     * @tparam Sig the signature, such as `void()`
+     * @tparam Size the inline buffer, TICKER_CXX_SMALL_FUNCTION_SIZE
+     * (48) bytes by default
+     */
+  template<typename R, typename... Args, std::size_t Size>
+  class small_function<R(Args...), Size> {
+  public:
+    static constexpr std::size_t buffer_size = Size < sizeof(void *) ? sizeof(void *) : Size;
+    template<typename F>
+    static constexpr bool fits_inline = sizeof(F) <= buffer_size &&
+                                        alignof(std::max_align_t) % alignof(F) == 0 &&
+                                        std::is_nothrow_move_constructible_v<F>;
+
+    small_function() noexcept = default;
+    small_function(std::nullptr_t) noexcept {}
+    template<typename F, typename D = std::decay_t<F>,
+             typename = std::enable_if_t<!std::is_same_v<D, small_function> && std::is_invocable_r_v<R, D &, Args...>>>
+    small_function(F &&f) {
+      if constexpr (!std::is_function_v<std::remove_reference_t<F>> &&
+                    (std::is_pointer_v<D> || std::is_member_pointer_v<D> || detail::is_std_function<D>::value)) {
+        if (!f) return; // a null one makes an empty small_function
+      }
+      if constexpr (fits_inline<D>) {
+        ::new (static_cast<void *>(_buf)) D(std::forward<F>(f));
+        _ops = &inline_ops<D>;
+      } else {
+        ::new (static_cast<void *>(_buf)) D *(new D(std::forward<F>(f)));
+        _ops = &heap_ops<D>;
+      }
+    }
+    small_function(small_function &&o) noexcept { take(o); }
+    small_function &operator=(small_function &&o) noexcept {
+      if (this != &o) {
+        reset();
+        take(o);
+      }
+      return *this;
+    }
+    small_function &operator=(std::nullptr_t) noexcept {
+      reset();
+      return *this;
+    }
+    small_function(small_function const &) = delete;
+    small_function &operator=(small_function const &) = delete;
+    ~small_function() { reset(); }
+
+    R operator()(Args... args) const {
+      if (!_ops) throw std::bad_function_call();
+      return _ops->invoke(_buf, std::forward<Args>(args)...);
+    }
+    explicit operator bool() const noexcept { return _ops != nullptr; }
+    // whether the callable lives in the inline buffer
+    bool is_inline() const noexcept { return _ops && _ops->inline_; }
+
+  private:
+    struct ops {
+      R (*invoke)(void *, Args &&...);
+      void (*move)(void *from, void *to) noexcept; // move-constructs to, and destroys from
+      void (*destroy)(void *) noexcept;
+      bool inline_;
+    };
+    template<typename D>
+    static constexpr ops inline_ops{
+            [](void *p, Args &&...args) -> R { return std::invoke(*static_cast<D *>(p), std::forward<Args>(args)...); },
+            [](void *from, void *to) noexcept {
+              ::new (to) D(std::move(*static_cast<D *>(from)));
+              static_cast<D *>(from)->~D();
+            },
+            [](void *p) noexcept { static_cast<D *>(p)->~D(); },
+            true,
+    };
+    template<typename D>
+    static constexpr ops heap_ops{
+            [](void *p, Args &&...args) -> R { return std::invoke(**static_cast<D **>(p), std::forward<Args>(args)...); },
+            [](void *from, void *to) noexcept { ::new (to) D *(*static_cast<D **>(from)); },
+            [](void *p) noexcept { delete *static_cast<D **>(p); },
+            false,
+    };
+
+    void take(small_function &o) noexcept {
+      if (o._ops) {
+        o._ops->move(o._buf, _buf);
+        _ops = std::exchange(o._ops, nullptr);
+      }
+    }
+    void reset() noexcept {
+      if (_ops) std::exchange(_ops, nullptr)->destroy(_buf);
+    }
+
+  private:
+    alignas(std::max_align_t) mutable unsigned char _buf[buffer_size];
+    ops const *_ops{nullptr};
+  }; // class small_function
+
+} // namespace ticker::util
+
+#endif //TICKER_CXX_TICKER_SMALL_FUNCTION_HH
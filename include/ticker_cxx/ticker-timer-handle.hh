@@ -0,0 +1,263 @@
+// ticker_cxx Library
+// Copyright © 2021 Hedzr Yeh.
+//
+// This file is released under the terms of the MIT license.
+// Read /LICENSE for more information.
+
+//
+// Created by Hedzr Yeh on 2021/11/05.
+//
+
+#ifndef TICKER_CXX_TICKER_TIMER_HANDLE_HH
+#define TICKER_CXX_TICKER_TIMER_HANDLE_HH
+
+#include "ticker-timer-job.hh"
+#include "ticker-timing-wheel.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace ticker {
+
+  namespace detail {
+    class job_registry;
+  } // namespace detail
+
+  /**
+     * @brief a lightweight handle to a scheduled job, returned by build().
+     * @details A handle is a slot id plus the generation of the slot. The
+     * generation changes once the job fires (one-shot jobs) or is
+     * cancelled, so a stale handle never cancels another job which
+     * reuses the slot.
+     * @note A handle must not outlive the scheduler of the timer which
+     * issued it.
+     */
+  class timer_handle {
+  public:
+    static constexpr std::uint32_t npos = std::numeric_limits<std::uint32_t>::max();
+
+    timer_handle() = default;
+    timer_handle(detail::job_registry *reg, std::uint32_t id, std::uint32_t gen)
+        : _reg(reg), _id(id), _gen(gen) {}
+
+    std::uint32_t id() const { return _id; }
+    std::uint32_t generation() const { return _gen; }
+    explicit operator bool() const { return _reg != nullptr; }
+
+    /**
+         * @brief cancel the job in O(1).
+         * @return false if the job has fired (one-shot), or was cancelled already.
+         */
+    inline bool cancel() const;
+    /**
+         * @brief whether the job is still scheduled.
+         */
+    inline bool pending() const;
+
+  private:
+    detail::job_registry *_reg{nullptr};
+    std::uint32_t _id{npos};
+    std::uint32_t _gen{0};
+  }; // class timer_handle
+
+  namespace detail {
+
+    /**
+     * @brief the jobs attached by one front-end (a timer_t) of a shared
+     * scheduler, so that they can be cancelled together when it detaches.
+     * @details The {id, generation} of each handle issued, under a mutex
+     * of its own. The ones gone stale (fired or cancelled by handle) are
+     * dropped lazily, when the list doubles.
+     */
+    struct job_owner {
+      mutable std::mutex m{};
+      std::vector<std::pair<std::uint32_t, std::uint32_t>> ids{};
+      std::size_t compact_at{64};
+    };
+
+    /**
+     * @brief the slot table behind timer_handle.
+     * @details Cancelling marks the job and frees its slot, the job
+     * itself stays in the timer queue until it is due and gets dropped
+     * by the runner there, so no bucket is searched.
+     *
+     * The slots live in segments which never move, segment k holding
+     * 64 << k of them. Each slot has an atomic word of its generation,
+     * a live bit and a cancelling bit: cancel(), pending() and release()
+     * are a CAS or a load on it, the CAS from live deciding whether a
+     * one-shot job is cancelled or fires. The free slots are a lock-free stack linked through
+     * the slots, its head tagged by a counter against ABA, so attach()
+     * takes no lock either, except the mutex of its job_owner.
+     */
+    class job_registry {
+    public:
+      job_registry() = default;
+      job_registry(job_registry const &) = delete;
+      job_registry &operator=(job_registry const &) = delete;
+      ~job_registry() {
+        for (auto &seg : _segments) delete[] seg.load(std::memory_order_relaxed);
+      }
+
+      timer_handle attach(job_base &j, job_owner *owner = nullptr) {
+        timer_handle h = attach_slot(j);
+        if (owner) own(*owner, &h, &h + 1);
+        return h;
+      }
+      // attaches a batch, recorded to owner under one lock; proj(*it) returns the job_base &
+      template<typename It, typename Proj>
+      void attach_all(It first, It last, Proj &&proj, std::vector<timer_handle> &out, job_owner *owner = nullptr) {
+        auto from = out.size();
+        for (; first != last; ++first)
+          out.emplace_back(attach_slot(proj(*first)));
+        if (owner) own(*owner, out.data() + from, out.data() + out.size());
+      }
+      // marks the job cancelled while the slot is still held, then frees
+      // the slot: release() waits for the mark rather than fire the job
+      bool cancel(std::uint32_t id, std::uint32_t gen) {
+        slot *s = find(id);
+        auto expected = live_state(gen);
+        if (!s || !s->state.compare_exchange_strong(expected, expected | cancelling, std::memory_order_acq_rel))
+          return false;
+        s->job.load(std::memory_order_relaxed)->cancel();
+        free_slot(*s, id, gen);
+        return true;
+      }
+      bool pending(std::uint32_t id, std::uint32_t gen) const {
+        slot const *s = find(id);
+        return s && s->state.load(std::memory_order_acquire) == live_state(gen);
+      }
+      /**
+         * @brief a one-shot job is due, or removed: its handle becomes stale.
+         * @return false if the job is cancelled, by a cancel() of its
+         * handle which took the slot first, or before; the runner must
+         * not launch it then
+         */
+      bool release(job_base &j) {
+        if (slot *s = find(j._handle_id)) {
+          for (;;) {
+            auto st = s->state.load(std::memory_order_acquire);
+            if (!(st & live) || s->job.load(std::memory_order_acquire) != &j) break;
+            if (st & cancelling) { // the job is marked in a moment
+              std::this_thread::yield();
+              continue;
+            }
+            if (s->state.compare_exchange_weak(st, st | cancelling, std::memory_order_acq_rel)) {
+              free_slot(*s, j._handle_id, std::uint32_t(st >> 2));
+              return !j.cancelled();
+            }
+          }
+        }
+        return !j.cancelled();
+      }
+      // cancels all jobs of an owner, returns the count of them
+      std::size_t cancel_all(job_owner &owner) {
+        std::unique_lock<std::mutex> l(owner.m);
+        std::size_t count{};
+        for (auto const &it : owner.ids)
+          if (cancel(it.first, it.second)) count++;
+        owner.ids.clear();
+        return count;
+      }
+      // the count of pending handles
+      std::size_t size() const { return _size.load(std::memory_order_relaxed); }
+      std::size_t size(job_owner const &owner) const {
+        std::unique_lock<std::mutex> l(owner.m);
+        return std::size_t(std::count_if(owner.ids.begin(), owner.ids.end(), [this](auto const &it) { return pending(it.first, it.second); }));
+      }
+
+    private:
+      static constexpr std::uint32_t segment0 = 64; // the slots of segment 0
+      static constexpr int segments = 26;           // 64 << 26 slots are enough for any id
+
+      struct slot {
+        std::atomic<std::uint64_t> state{0}; // the generation << 2, | live while a job is attached, | cancelling while it's being freed
+        std::atomic<job_base *> job{nullptr};
+        std::atomic<std::uint32_t> next{timer_handle::npos}; // in the free list
+      };
+
+      static constexpr std::uint64_t live = 1, cancelling = 2;
+      static std::uint64_t live_state(std::uint32_t gen) { return (std::uint64_t(gen) << 2) | live; }
+      static int segment_of(std::uint32_t id) { return queue::detail::highest_bit(id / segment0 + 1); }
+      static std::uint32_t offset_of(std::uint32_t id, int k) { return id - segment0 * ((std::uint32_t(1) << k) - 1); }
+      slot &at(std::uint32_t id) const {
+        int k = segment_of(id);
+        return _segments[k].load(std::memory_order_acquire)[offset_of(id, k)];
+      }
+      // the slot of an id from a handle, nullptr if no such slot was made
+      slot *find(std::uint32_t id) const {
+        if (id == timer_handle::npos) return nullptr;
+        int k = segment_of(id);
+        slot *seg = k < segments ? _segments[k].load(std::memory_order_acquire) : nullptr;
+        return seg ? seg + offset_of(id, k) : nullptr;
+      }
+      // the head of the free list: a tag << 32 | the id of the top slot
+      static std::uint64_t free_head(std::uint64_t tag, std::uint32_t id) { return (tag << 32) | id; }
+
+      // pops a free slot, or makes one
+      std::uint32_t take_slot() {
+        auto head = _free.load(std::memory_order_acquire);
+        while (std::uint32_t(head) != timer_handle::npos) {
+          auto next = at(std::uint32_t(head)).next.load(std::memory_order_relaxed);
+          if (_free.compare_exchange_weak(head, free_head((head >> 32) + 1, next), std::memory_order_acquire, std::memory_order_acquire))
+            return std::uint32_t(head);
+        }
+        auto id = _made.fetch_add(1, std::memory_order_relaxed);
+        int k = segment_of(id);
+        if (!_segments[k].load(std::memory_order_acquire)) {
+          slot *seg = new slot[std::size_t(segment0) << k], *expected = nullptr;
+          if (!_segments[k].compare_exchange_strong(expected, seg, std::memory_order_acq_rel))
+            delete[] seg; // made by another thread meanwhile
+        }
+        return id;
+      }
+      timer_handle attach_slot(job_base &j) {
+        auto id = take_slot();
+        auto &s = at(id);
+        auto gen = std::uint32_t(s.state.load(std::memory_order_relaxed) >> 2);
+        s.job.store(&j, std::memory_order_relaxed);
+        j._handle_id = id;
+        s.state.store(live_state(gen), std::memory_order_release);
+        _size.fetch_add(1, std::memory_order_relaxed);
+        return timer_handle{this, id, gen};
+      }
+      // records the handles of an owner, dropping the stale ones when the list doubles
+      void own(job_owner &owner, timer_handle const *first, timer_handle const *last) {
+        std::unique_lock<std::mutex> l(owner.m);
+        for (; first != last; ++first) owner.ids.emplace_back(first->id(), first->generation());
+        if (owner.ids.size() >= owner.compact_at) {
+          owner.ids.erase(std::remove_if(owner.ids.begin(), owner.ids.end(), [this](auto const &it) { return !pending(it.first, it.second); }),
+                          owner.ids.end());
+          owner.compact_at = std::max<std::size_t>(64, owner.ids.size() * 2);
+        }
+      }
+      // ends the generation gen of the slot id, held by the caller with
+      // the cancelling bit, then pushes the slot onto the free list
+      void free_slot(slot &s, std::uint32_t id, std::uint32_t gen) {
+        s.state.store(std::uint64_t(std::uint32_t(gen + 1)) << 2, std::memory_order_release);
+        _size.fetch_sub(1, std::memory_order_relaxed);
+        auto head = _free.load(std::memory_order_relaxed);
+        do {
+          s.next.store(std::uint32_t(head), std::memory_order_relaxed);
+        } while (!_free.compare_exchange_weak(head, free_head((head >> 32) + 1, id), std::memory_order_release, std::memory_order_relaxed));
+      }
+
+      std::atomic<slot *> _segments[segments]{};
+      std::atomic<std::uint32_t> _made{0}; // the slot ids handed out, free or not
+      std::atomic<std::uint64_t> _free{free_head(0, timer_handle::npos)};
+      std::atomic<std::size_t> _size{0};
+    }; // class job_registry
+
+  } // namespace detail
+
+  inline bool timer_handle::cancel() const { return _reg && _reg->cancel(_id, _gen); }
+  inline bool timer_handle::pending() const { return _reg && _reg->pending(_id, _gen); }
+
+} // namespace ticker
+
+#endif //TICKER_CXX_TICKER_TIMER_HANDLE_HH
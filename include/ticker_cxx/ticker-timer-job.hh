@@ -12,37 +12,103 @@
 #define TICKER_CXX_TICKER_TIMER_JOB_HH
 
 #include "ticker-chrono.hh"
+#include "ticker-intrusive-list.hh"
 #include "ticker-pool.hh"
+#include "ticker-small-function.hh"
 
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <memory>
+#include <type_traits>
 
 namespace ticker {
 
+  namespace detail {
+    class job_registry;
+  } // namespace detail
+
   using Clock = std::chrono::system_clock;
 
-  class timer_job {
+  /**
+     * @brief the callable of a job, move-only, the common captures are
+     * kept inline without a heap allocation.
+     */
+  using job_fn = util::small_function<void()>;
+
+  /**
+     * @brief the clock independent states of a scheduled job: the cancel
+     * flag, the slack and the slot of its handle.
+     */
+  class job_base {
   public:
-    explicit timer_job(std::function<void()> &&f, bool recur = false, bool interval = false)
-        : _recur(recur), _interval(interval), _f(std::move(f)), _hit(0) {}
-    virtual ~timer_job() {}
-    Clock::time_point next_time_point() const { return next_time_point(Clock::now()); }
-    virtual Clock::time_point next_time_point(Clock::time_point const now) const = 0;
+    job_base() = default;
+    virtual ~job_base() {}
 
-    void launch_to(pool::thread_pool &p, std::function<void(timer_job *tj)> const &post_job = nullptr) {
-      launch_fn_to_pool(_f, p, post_job);
-    }
+    /**
+         * @brief a cancelled job will not be launched any more, it is
+         * dropped by the runner when it is due.
+         */
+    void cancel() { _cancelled.store(true, std::memory_order_release); }
+    bool cancelled() const { return _cancelled.load(std::memory_order_acquire); }
 
-    std::size_t hits() const { return _hit; }
-    void operator()() { _f(); }
+    /**
+         * @brief the tolerated lateness: the runner may fire the job
+         * anywhere in [due, due + slack] to share a wakeup with others.
+         */
+    std::chrono::nanoseconds slack() const { return _slack; }
+    void slack(std::chrono::nanoseconds d) { _slack = d; }
 
   private:
-    void launch_fn_to_pool(std::function<void()> const &fn, pool::thread_pool &pool, std::function<void(timer_job *tj)> const &post_job = nullptr) {
-      pool.queue_task([=]() {
-        fn();
-        if (post_job)
-          post_job(this);
-      });
+    friend class detail::job_registry;
+    std::atomic<bool> _cancelled{false};
+    std::uint32_t _handle_id{UINT32_MAX}; // the slot in job_registry
+    std::chrono::nanoseconds _slack{0};
+  };
+
+  /**
+     * @brief the base class of the scheduled jobs on a Clock.
+     * @details A job must be owned by a std::shared_ptr: each launched pool
+     * task holds a reference to it, so a fired one-shot job is released as
+     * soon as its pool task completes.
+     * @tparam C the clock of the time points, std::chrono::steady_clock
+     * keeps a duration based job away from the wall clock steps.
+     */
+  template<typename C = Clock>
+  class basic_timer_job : public job_base, public std::enable_shared_from_this<basic_timer_job<C>> {
+  public:
+    using clock = C;
+    using time_point = typename C::time_point;
+
+    explicit basic_timer_job(job_fn &&f, bool recur = false, bool interval = false)
+        : _recur(recur), _interval(interval), _f(std::move(f)), _hit(0) {}
+    virtual ~basic_timer_job() {}
+    time_point next_time_point() const { return next_time_point(C::now()); }
+    virtual time_point next_time_point(time_point const now) const = 0;
+    /**
+         * @brief moves the job on to its next firing and returns its
+         * time point, called by the runner once per firing.
+         * @details next_time_point() is a query only; a job which keeps
+         * the state of its recurrence, such as a fixed-rate every_job,
+         * updates it here.
+         */
+    virtual time_point advance(time_point const now) { return next_time_point(now); }
+
+    // posts the job to an executor, such as pool::thread_pool or
+    // pool::any_executor, then post_job(this) if given. An executor
+    // taking deadlines gets the due time of the job.
+    template<typename Executor, typename PostJob = std::nullptr_t>
+    void launch_to(Executor &e, PostJob &&post_job = nullptr) {
+      // a shared_ptr and a pointer or two, fits the inline buffer of pool::task_fn
+      auto task = [post_job = std::forward<PostJob>(post_job), self = this->shared_from_this()]() {
+        self->_f();
+        if constexpr (!std::is_same_v<std::decay_t<PostJob>, std::nullptr_t>)
+          post_job(self.get());
+      };
+      if constexpr (pool::is_deadline_executor_v<Executor>)
+        e.post(std::move(task), deadline());
+      else
+        e.post(std::move(task));
 #if defined(_DEBUG) || TICKER_CXX_TEST_THREAD_POOL_DBGOUT
       if ((_hit % 10) == 0)
         pool_debug("job launched, %p (_recur=%d, _interval=%d, hit=%u)", (void *) this, _recur, _interval, _hit);
@@ -51,15 +117,68 @@ namespace ticker {
       std::this_thread::yield();
     }
 
+    std::size_t hits() const { return _hit; }
+    void operator()() { _f(); }
+
+    /**
+         * @brief the time point the job was last scheduled at, set by
+         * the scheduler when it's added.
+         */
+    time_point due() const { return _due; }
+    void due(time_point tp) { _due = tp; }
+    // due() on the steady clock, the deadline of the launched task
+    pool::deadline_t deadline() const {
+      if constexpr (std::is_same_v<C, std::chrono::steady_clock>)
+        return _due;
+      else
+        return std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(_due - C::now());
+    }
+
+    // the links of queue::intrusive_list, nullptr but on a hooked_job
+    virtual queue::intrusive_hook<basic_timer_job> *queue_hook() { return nullptr; }
+
   public:
     bool _recur;
     bool _interval;
 
   protected:
-    std::function<void()> _f;
+    job_fn _f;
     std::size_t _hit;
+    time_point _due{};
+  };
+
+  using timer_job = basic_timer_job<Clock>;
+
+  /**
+     * @brief the job J with the links of queue::intrusive_list.
+     * @details scheduler::make_job() makes the jobs so for an intrusive
+     * QueuePolicy, such as queue::intrusive_wheel_policy, the jobs of
+     * the other policies don't carry the links.
+     */
+  template<typename J>
+  class hooked_job : public J {
+  public:
+    using J::J;
+    using hook_type = queue::intrusive_hook<basic_timer_job<typename J::clock>>;
+    hook_type *queue_hook() override { return &_hook; }
+
+  private:
+    hook_type _hook{};
   };
 
+  namespace detail {
+    // whether a job type never recurs, by its `static constexpr bool one_shot`
+    template<typename J, typename = void>
+    struct is_one_shot : std::false_type {};
+    template<typename J>
+    struct is_one_shot<J, std::void_t<decltype(J::one_shot)>> : std::bool_constant<J::one_shot> {};
+    // whether the jobs of a QueuePolicy are hooked_job, by its `static constexpr bool hooked`
+    template<typename P, typename = void>
+    struct is_hooked : std::false_type {};
+    template<typename P>
+    struct is_hooked<P, std::void_t<decltype(P::hooked)>> : std::bool_constant<P::hooked> {};
+  } // namespace detail
+
 } // namespace ticker
 
 #endif //TICKER_CXX_TICKER_TIMER_JOB_HH
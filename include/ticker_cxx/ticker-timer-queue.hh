@@ -0,0 +1,189 @@
+// ticker_cxx Library
+// Copyright © 2021 Hedzr Yeh.
+//
+// This file is released under the terms of the MIT license.
+// Read /LICENSE for more information.
+
+//
+// Created by Hedzr Yeh on 2021/11/02.
+//
+
+#ifndef TICKER_CXX_TICKER_TIMER_QUEUE_HH
+#define TICKER_CXX_TICKER_TIMER_QUEUE_HH
+
+#include "ticker-dary-heap.hh"
+#include "ticker-intrusive-list.hh"
+#include "ticker-slab.hh"
+#include "ticker-timing-wheel.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace ticker::queue {
+
+  /**
+     * @brief map_queue keeps the pending jobs in a std::map, grouped by time point.
+     * @details pop_expired() is O(log n + k) for k expired buckets, it
+     * compares the time points at the full resolution of the clock.
+     *
+     * Given a pool::slab_arena, the map nodes and the bucket storage
+     * come from it, so a churn of distinct time points recycles the
+     * same blocks instead of going to the heap for each of them.
+     * @tparam Clock the clock of the time points
+     * @tparam J     the job handle type, such as `std::shared_ptr<timer_job>`
+     *
+     * @details All timer queues share the same contract so that the
+     * runner loop of timer_t stays generic:
+     * @code{c++}
+     *   std::size_t add(time_point const &tp, J &&job);        // returns the count of pending jobs
+     *   std::size_t add_sorted(items_t &&items);                // items sorted by time point, same as add()
+     *   std::size_t remove(time_point const &tp, J const &job); // returns the count of pending jobs
+     *   bool pop_expired(time_point const &now, jobs_t &out);   // appends all due jobs to out
+     *   bool next_time_point(time_point &tp) const;             // false if nothing is pending
+     *   std::size_t size() const;
+     *   bool empty() const;
+     *   void clear();
+     * @endcode
+     * The queues are not thread-safe, timer_t serializes the accesses.
+     *
+     * A queue policy is a type with a member alias template
+     * `queue_t<Clock, J>` naming the queue, see map_policy,
+     * heap_policy and wheel_policy.
+     */
+  template<typename Clock, typename J>
+  class map_queue {
+  public:
+    using time_point = typename Clock::time_point;
+    using job_type = J;
+    using jobs_t = std::vector<J>;
+    using items_t = std::vector<std::pair<time_point, J>>;
+    using bucket = std::vector<J, pool::slab_allocator<J>>;
+    using container = std::map<time_point, bucket, std::less<time_point>, pool::slab_allocator<std::pair<const time_point, bucket>>>;
+
+    map_queue() = default;
+    explicit map_queue(std::shared_ptr<pool::slab_arena> arena)
+        : _c(typename container::allocator_type(std::move(arena))) {}
+
+    std::size_t add(time_point const &tp, J &&job) {
+      auto it = _c.find(tp);
+      if (it == _c.end()) {
+        it = _c.emplace_hint(it, std::piecewise_construct, std::forward_as_tuple(tp), std::forward_as_tuple(_c.get_allocator()));
+        (*it).second.emplace_back(std::move(job));
+      } else {
+        (*it).second.emplace_back(std::move(job));
+      }
+      return ++_count;
+    }
+    // the sorted items go in with a moving hint, amortized O(1) each
+    // while they don't interleave with the existing buckets.
+    std::size_t add_sorted(items_t &&items) {
+      auto hint = _c.end();
+      for (auto &it : items) {
+        if (hint == _c.end() || (*hint).first != it.first)
+          hint = _c.try_emplace(hint == _c.end() ? hint : std::next(hint), it.first, _c.get_allocator());
+        (*hint).second.emplace_back(std::move(it.second));
+      }
+      _count += items.size();
+      return _count;
+    }
+    std::size_t remove(time_point const &tp, J const &job) {
+      auto it = _c.find(tp);
+      if (it != _c.end()) {
+        auto &coll = (*it).second;
+        auto end = std::remove(coll.begin(), coll.end(), job);
+        _count -= (std::size_t) std::distance(end, coll.end());
+        coll.erase(end, coll.end());
+        if (coll.empty())
+          _c.erase(it);
+      }
+      return _count;
+    }
+    bool pop_expired(time_point const &now, jobs_t &out) {
+      auto itp = find_next(now);
+      if (itp == _c.begin())
+        return false;
+      for (auto it = _c.begin(); it != itp; ++it) {
+        auto &coll = (*it).second;
+        _count -= coll.size();
+        std::move(coll.begin(), coll.end(), std::back_inserter(out));
+      }
+      _c.erase(_c.begin(), itp);
+      return true;
+    }
+    bool next_time_point(time_point &tp) const {
+      if (_c.empty()) return false;
+      tp = (*_c.begin()).first;
+      return true;
+    }
+    std::size_t size() const { return _count; }
+    bool empty() const { return _c.empty(); }
+    void clear() { _c.clear(), _count = 0; }
+
+  private:
+    // returns the first bucket which is not expired yet, in O(log n)
+    typename container::iterator find_next(time_point const &now) {
+      return _c.upper_bound(now);
+    }
+
+  private:
+    container _c{};
+    std::size_t _count{0};
+  }; // class map_queue
+
+  /**
+     * @brief the queue policy of timer_t: keep the jobs in a std::map.
+     */
+  struct map_policy {
+    template<typename Clock, typename J>
+    using queue_t = map_queue<Clock, J>;
+  };
+
+  /**
+     * @brief the queue policy of timer_t: keep the jobs in an implicit
+     * d-ary min-heap (4-ary by default).
+     * @see ticker::queue::dary_heap_queue
+     */
+  template<std::size_t Arity = 4>
+  struct heap_policy {
+    template<typename Clock, typename J>
+    using queue_t = dary_heap_queue<Clock, J, Arity>;
+  };
+
+  /**
+     * @brief the queue policy of timer_t: keep the jobs in a hierarchical
+     * hashed timing wheel.
+     * @tparam Tick      the tick resolution, such as `std::chrono::microseconds`
+     * @tparam SlotBits  each level has `1 << SlotBits` slots
+     * @tparam Levels    the number of levels
+     * @see ticker::queue::timing_wheel
+     */
+  template<typename Tick = std::chrono::milliseconds, std::size_t SlotBits = 8, std::size_t Levels = 4>
+  struct wheel_policy {
+    template<typename Clock, typename J>
+    using queue_t = timing_wheel<Clock, J, Tick, SlotBits, Levels>;
+  };
+
+  /**
+     * @brief the queue policy of timer_t: a timing wheel whose slots
+     * are intrusive lists threaded through the jobs themselves.
+     * @details Scheduling and removing a job is O(1) without allocating
+     * or touching its reference count, the queue's reference is moved
+     * into the job's hook. The scheduler makes its jobs as hooked_job
+     * to have the hook. See wheel_policy for the parameters.
+     */
+  template<typename Tick = std::chrono::milliseconds, std::size_t SlotBits = 8, std::size_t Levels = 4>
+  struct intrusive_wheel_policy {
+    static constexpr bool hooked = true;
+    template<typename Clock, typename J>
+    using queue_t = timing_wheel<Clock, J, Tick, SlotBits, Levels, intrusive_list>;
+  };
+
+} // namespace ticker::queue
+
+#endif //TICKER_CXX_TICKER_TIMER_QUEUE_HH
@@ -0,0 +1,145 @@
+// ticker_cxx Library
+// Copyright © 2021 Hedzr Yeh.
+//
+// This file is released under the terms of the MIT license.
+// Read /LICENSE for more information.
+
+//
+// Created by Hedzr Yeh on 2021/11/08.
+//
+
+#ifndef TICKER_CXX_TICKER_TIMERFD_HH
+#define TICKER_CXX_TICKER_TIMERFD_HH
+
+#if defined(__linux__)
+
+#if !defined(TICKER_CXX_HAS_TIMERFD)
+#define TICKER_CXX_HAS_TIMERFD 1
+#endif
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <initializer_list>
+#include <system_error>
+#include <type_traits>
+
+namespace ticker::pool {
+
+  /**
+     * @brief the Linux runner backend of timer_t: a timerfd armed with
+     * TFD_TIMER_ABSTIME for the next deadline, waited on by epoll.
+     * @details An eventfd in the same epoll set carries kick() and
+     * kill(), so neither of them takes a mutex. A kick before the
+     * waiter sleeps is not lost, the eventfd counter keeps it.
+     *
+     * The deadlines of std::chrono::system_clock arm a CLOCK_REALTIME
+     * timerfd, the others arm a CLOCK_MONOTONIC one (the ones of a
+     * clock other than std::chrono::steady_clock are converted).
+     *
+     * timerfd_waiter has the same interface as timer_killer, use it
+     * as the Waiter parameter of timer_t:
+     * @code{c++}
+     * using fd_timer = ticker::timer_t<std::nullopt_t, ticker::Clock, false,
+     *                                  ticker::detail::in_job<ticker::Clock, false>,
+     *                                  ticker::queue::map_policy,
+     *                                  ticker::pool::timerfd_waiter>;
+     * @endcode
+     */
+  class timerfd_waiter {
+  public:
+    timerfd_waiter() {
+      _ep = epoll_create1(EPOLL_CLOEXEC);
+      _ev = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+      _tfd_real = timerfd_create(CLOCK_REALTIME, TFD_NONBLOCK | TFD_CLOEXEC);
+      _tfd_mono = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+      if (_ep < 0 || _ev < 0 || _tfd_real < 0 || _tfd_mono < 0) {
+        int err = errno;
+        close_all();
+        throw std::system_error(err, std::generic_category(), "timerfd_waiter");
+      }
+      for (int fd : {_ev, _tfd_real, _tfd_mono}) {
+        epoll_event e{};
+        e.events = EPOLLIN;
+        e.data.fd = fd;
+        epoll_ctl(_ep, EPOLL_CTL_ADD, fd, &e);
+      }
+    }
+    ~timerfd_waiter() { close_all(); }
+    timerfd_waiter(timerfd_waiter const &) = delete;
+    timerfd_waiter &operator=(timerfd_waiter const &) = delete;
+
+    const bool ConditionMatched = true;
+    bool terminated() const { return _killed.load(std::memory_order_acquire); }
+
+    /**
+         * @brief wait until a time point, or until killed or kicked.
+         * @return true if killed, false while timeout or kicked.
+         */
+    template<class C, class D>
+    bool wait_until_or_kick(std::chrono::time_point<C, D> const &timeout_time) {
+      using namespace std::chrono;
+      if (terminated()) return true;
+      int tfd = _tfd_mono;
+      nanoseconds abs;
+      if constexpr (std::is_same_v<C, system_clock>) {
+        tfd = _tfd_real;
+        abs = duration_cast<nanoseconds>(timeout_time.time_since_epoch());
+      } else if constexpr (std::is_same_v<C, steady_clock>) {
+        abs = duration_cast<nanoseconds>(timeout_time.time_since_epoch());
+      } else {
+        abs = duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()) +
+              duration_cast<nanoseconds>(timeout_time - C::now());
+      }
+      if (abs <= nanoseconds::zero()) abs = nanoseconds(1); // zero would disarm it
+      itimerspec its{};
+      its.it_value.tv_sec = (time_t) duration_cast<seconds>(abs).count();
+      its.it_value.tv_nsec = (long) (abs % seconds(1)).count();
+      timerfd_settime(tfd, TFD_TIMER_ABSTIME, &its, nullptr);
+
+      epoll_event events[3];
+      int n = epoll_wait(_ep, events, 3, -1);
+      for (int i = 0; i < n; i++) {
+        std::uint64_t v;
+        [[maybe_unused]] auto r = ::read(events[i].data.fd, &v, sizeof(v));
+      }
+      return terminated();
+    }
+    /**
+         * @brief wake up the waiter without killing it.
+         */
+    void kick() { signal(); }
+    void kill() {
+      _killed.store(true, std::memory_order_release);
+      signal();
+    }
+
+  private:
+    void signal() {
+      std::uint64_t one = 1;
+      [[maybe_unused]] auto r = ::write(_ev, &one, sizeof(one));
+    }
+    void close_all() {
+      for (int *fd : {&_tfd_mono, &_tfd_real, &_ev, &_ep}) {
+        if (*fd >= 0) ::close(*fd);
+        *fd = -1;
+      }
+    }
+
+  private:
+    int _ep{-1}, _ev{-1}, _tfd_real{-1}, _tfd_mono{-1};
+    std::atomic<bool> _killed{false};
+  }; // class timerfd_waiter
+
+} // namespace ticker::pool
+
+#endif // defined(__linux__)
+
+#endif //TICKER_CXX_TICKER_TIMERFD_HH
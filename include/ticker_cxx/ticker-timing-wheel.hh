@@ -0,0 +1,326 @@
+// ticker_cxx Library
+// Copyright © 2021 Hedzr Yeh.
+//
+// This file is released under the terms of the MIT license.
+// Read /LICENSE for more information.
+
+//
+// Created by Hedzr Yeh on 2021/11/02.
+//
+
+#ifndef TICKER_CXX_TICKER_TIMING_WHEEL_HH
+#define TICKER_CXX_TICKER_TIMING_WHEEL_HH
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace ticker::queue::detail {
+
+  inline int highest_bit(std::uint64_t x) { // x must not be zero
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(x);
+#else
+    int r = 0;
+    while (x >>= 1) ++r;
+    return r;
+#endif
+  }
+
+  inline int lowest_bit(std::uint64_t x) { // x must not be zero
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    int r = 0;
+    while ((x & 1) == 0) x >>= 1, ++r;
+    return r;
+#endif
+  }
+
+  /**
+     * @brief the default bucket of timing_wheel, a vector of
+     * (expire, job) pairs. It keeps its capacity once grown.
+     */
+  template<typename J>
+  class vector_bucket {
+  public:
+    using job_type = J;
+
+    void push(std::int64_t expire, J &&job) { _v.push_back(entry{expire, std::move(job)}); }
+    bool remove(J const &job) {
+      for (auto it = _v.begin(); it != _v.end(); ++it) {
+        if ((*it).job == job) {
+          if (it + 1 != _v.end())
+            (*it) = std::move(_v.back());
+          _v.pop_back();
+          return true;
+        }
+      }
+      return false;
+    }
+    // f may push back into this bucket, those are kept
+    template<typename F>
+    void drain(F &&f) {
+      auto n = _v.size();
+      for (std::size_t i = 0; i < n; ++i) {
+        J job = std::move(_v[i].job);
+        f(_v[i].expire, std::move(job));
+      }
+      _v.erase(_v.begin(), _v.begin() + (std::ptrdiff_t) n);
+    }
+    void clear() { _v.clear(); }
+    bool empty() const { return _v.empty(); }
+    std::size_t size() const { return _v.size(); }
+
+  private:
+    struct entry {
+      std::int64_t expire;
+      J job;
+    };
+    std::vector<entry> _v{};
+  }; // class vector_bucket
+
+} // namespace ticker::queue::detail
+
+namespace ticker::queue {
+
+  /**
+     * @brief a hierarchical hashed timing wheel (Varghese & Lauck, scheme 7).
+     * @tparam Clock     the clock of the time points
+     * @tparam J         the job handle type, such as `std::shared_ptr<timer_job>`
+     * @tparam Tick      the resolution of the wheel, one `Tick` is one slot of level 0
+     * @tparam SlotBits  each level has `1 << SlotBits` slots
+     * @tparam Levels    the number of levels
+     * @tparam Bucket    the storage of a slot, detail::vector_bucket, or
+     *                   intrusive_list which links the jobs through their
+     *                   own hooks (see intrusive_wheel_policy)
+     *
+     * @details A deadline is converted into an absolute tick number. The
+     * job will be hashed into the level of the highest base-`(1<<SlotBits)`
+     * digit in which the deadline differs from the current tick, the slot
+     * is the deadline's digit at that level. When the current tick reaches
+     * the beginning of a slot at level `l > 0`, the slot is cascaded down
+     * into the lower levels. Slots at level 0 hold the jobs expiring at
+     * exactly that tick.
+     *
+     * Insertion is O(1), expiring is amortized O(1) per job (a job cascades
+     * at most `Levels` times). Idle ticks are skipped by scanning the
+     * occupancy bitmaps, so a long sleep doesn't cost a walk over every
+     * elapsed tick.
+     *
+     * Deadlines farther than `1 << (SlotBits * Levels)` ticks are kept in
+     * an overflow bucket which is rehashed each time the top level wraps.
+     * The default settings (1ms, 4 levels of 256 slots) cover 49 days.
+     *
+     * A job never fires before its deadline: deadlines are rounded up to
+     * the next tick, the current time is rounded down.
+     *
+     * @note timing_wheel is not thread-safe, the owner holds the lock.
+     */
+  template<typename Clock, typename J,
+           typename Tick = std::chrono::milliseconds,
+           std::size_t SlotBits = 8,
+           std::size_t Levels = 4,
+           template<typename> class Bucket = detail::vector_bucket>
+  class timing_wheel {
+  public:
+    using time_point = typename Clock::time_point;
+    using job_type = J;
+    using jobs_t = std::vector<J>;
+    using items_t = std::vector<std::pair<time_point, J>>;
+    using tick_t = std::int64_t;
+
+    static constexpr std::size_t slot_bits = SlotBits;
+    static constexpr std::size_t slots = std::size_t(1) << SlotBits;
+    static constexpr std::size_t levels = Levels;
+    static_assert(SlotBits > 0 && Levels > 0 && SlotBits * Levels < 63, "timing_wheel: SlotBits * Levels must be in [1, 62]");
+
+    timing_wheel()
+        : _cur(floor_tick(Clock::now()))
+        , _buckets(slots * Levels)
+        , _bits(words * Levels) {}
+
+    /**
+         * @brief schedule a job at time point tp
+         * @return the count of pending jobs
+         */
+    std::size_t add(time_point const &tp, J &&job) {
+      place(ceil_tick(tp), std::move(job));
+      return ++_size;
+    }
+    std::size_t add_sorted(items_t &&items) {
+      for (auto &it : items)
+        place(ceil_tick(it.first), std::move(it.second));
+      _size += items.size();
+      return _size;
+    }
+    /**
+         * @brief remove a pending job which was scheduled at tp
+         * @return the count of pending jobs
+         */
+    std::size_t remove(time_point const &tp, J const &job) {
+      tick_t e = ceil_tick(tp);
+      if (e <= _cur) {
+        if (_ready.remove(job)) --_size;
+        return _size;
+      }
+      // the job sits at the level of e from _cur, or at a higher one,
+      // or in _overflow, if it was placed from an earlier _cur and the
+      // slot has not cascaded yet
+      for (auto level = level_of(e); level < Levels; ++level) {
+        auto idx = digit(e, level);
+        auto &b = slot(level, idx);
+        if (b.remove(job)) {
+          --_size;
+          if (b.empty()) unmark(level, idx);
+          return _size;
+        }
+      }
+      if (_overflow.remove(job)) --_size;
+      return _size;
+    }
+    /**
+         * @brief move all jobs whose deadline is not later than now into out.
+         * @return true if any job expired
+         */
+    bool pop_expired(time_point const &now, jobs_t &out) {
+      auto before = out.size();
+      advance(floor_tick(now), out);
+      return out.size() > before;
+    }
+    /**
+         * @brief the time point the owner should wake up at.
+         * @details it might be earlier than the real earliest deadline
+         * when the next event is a cascade of a higher level slot, in
+         * which case pop_expired() will return nothing and the owner
+         * simply asks again.
+         * @return false if the wheel is empty
+         */
+    bool next_time_point(time_point &tp) const {
+      if (_size == 0) return false;
+      if (!_ready.empty())
+        tp = to_time_point(_cur);
+      else
+        tp = to_time_point(next_event());
+      return true;
+    }
+    std::size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    void clear() {
+      for (auto &b : _buckets) b.clear();
+      for (auto &w : _bits) w = 0;
+      _ready.clear();
+      _overflow.clear();
+      _size = 0;
+    }
+
+    static tick_t floor_tick(time_point const &tp) { return std::chrono::floor<Tick>(tp.time_since_epoch()).count(); }
+    static tick_t ceil_tick(time_point const &tp) { return std::chrono::ceil<Tick>(tp.time_since_epoch()).count(); }
+    static time_point to_time_point(tick_t t) { return time_point(std::chrono::duration_cast<typename Clock::duration>(Tick(t))); }
+
+  private:
+    using bucket = Bucket<J>;
+    static constexpr std::size_t words = (slots + 63) / 64;
+    static constexpr std::uint64_t slot_mask = slots - 1;
+    static constexpr tick_t never = std::numeric_limits<tick_t>::max();
+
+    static std::size_t digit(tick_t t, std::size_t level) { return (std::size_t) ((std::uint64_t(t) >> (SlotBits * level)) & slot_mask); }
+    static std::uint64_t low_mask(std::size_t level) { return (std::uint64_t(1) << (SlotBits * level)) - 1; }
+    // the level of the highest digit in which e differs from the current tick, e > _cur
+    std::size_t level_of(tick_t e) const { return (std::size_t) detail::highest_bit(std::uint64_t(e) ^ std::uint64_t(_cur)) / SlotBits; }
+
+    bucket &slot(std::size_t level, std::size_t idx) { return _buckets[level * slots + idx]; }
+    void mark(std::size_t level, std::size_t idx) { _bits[level * words + idx / 64] |= (std::uint64_t(1) << (idx % 64)); }
+    void unmark(std::size_t level, std::size_t idx) { _bits[level * words + idx / 64] &= ~(std::uint64_t(1) << (idx % 64)); }
+
+    void place(tick_t expire, J &&job) {
+      if (expire <= _cur) {
+        _ready.push(expire, std::move(job));
+        return;
+      }
+      auto level = level_of(expire);
+      if (level >= Levels) {
+        _overflow.push(expire, std::move(job));
+        return;
+      }
+      auto idx = digit(expire, level);
+      slot(level, idx).push(expire, std::move(job));
+      mark(level, idx);
+    }
+
+    // the first occupied slot index at level which is >= from, or slots if none
+    std::size_t next_occupied(std::size_t level, std::size_t from) const {
+      for (std::size_t w = from / 64; w < words; ++w) {
+        std::uint64_t bits = _bits[level * words + w];
+        if (w == from / 64) bits &= ~((std::uint64_t(1) << (from % 64)) - 1);
+        if (bits) return w * 64 + (std::size_t) detail::lowest_bit(bits);
+      }
+      return slots;
+    }
+
+    // the next tick at which a slot has to be cascaded or expired
+    tick_t next_event() const {
+      tick_t t = never;
+      auto cur = std::uint64_t(_cur);
+      for (std::size_t level = 0; level < Levels; ++level) {
+        auto idx = next_occupied(level, digit(_cur, level) + 1);
+        if (idx >= slots) continue;
+        auto shift = SlotBits * level;
+        auto at = tick_t(((cur >> (shift + SlotBits)) << (shift + SlotBits)) | (std::uint64_t(idx) << shift));
+        if (at < t) t = at;
+      }
+      if (!_overflow.empty()) {
+        auto top = SlotBits * Levels;
+        auto at = tick_t(((cur >> top) + 1) << top);
+        if (at < t) t = at;
+      }
+      return t;
+    }
+
+    void advance(tick_t target, jobs_t &out) {
+      auto replace = [this](tick_t expire, J &&job) { place(expire, std::move(job)); };
+      auto fire = [&out](tick_t, J &&job) { out.emplace_back(std::move(job)); };
+      while (_size > _ready.size()) {
+        tick_t t = next_event();
+        if (t > target) break;
+        _cur = t;
+
+        if (!_overflow.empty() && (std::uint64_t(t) & low_mask(Levels)) == 0)
+          _overflow.drain(replace); // the far ones go back into _overflow
+        for (std::size_t level = Levels - 1; level > 0; --level) {
+          if ((std::uint64_t(t) & low_mask(level)) != 0) continue;
+          auto idx = digit(t, level);
+          auto &b = slot(level, idx);
+          if (b.empty()) continue;
+          unmark(level, idx);
+          b.drain(replace); // into the lower levels
+        }
+        auto idx = digit(t, 0);
+        auto &b = slot(0, idx);
+        if (!b.empty()) {
+          _size -= b.size();
+          b.drain(fire);
+          unmark(0, idx);
+        }
+      }
+      if (_cur < target) _cur = target;
+
+      _size -= _ready.size();
+      _ready.drain(fire);
+    }
+
+  private:
+    tick_t _cur;
+    std::size_t _size{0};
+    std::vector<bucket> _buckets;
+    std::vector<std::uint64_t> _bits;
+    bucket _ready{};
+    bucket _overflow{};
+  }; // class timing_wheel
+
+} // namespace ticker::queue
+
+#endif //TICKER_CXX_TICKER_TIMING_WHEEL_HH
@@ -0,0 +1,65 @@
+// ticker_cxx Library
+// Copyright © 2021 Hedzr Yeh.
+//
+// This file is released under the terms of the MIT license.
+// Read /LICENSE for more information.
+
+//
+// Created by Hedzr Yeh on 2021/11/09.
+//
+
+#ifndef TICKER_CXX_TICKER_WAIT_STRATEGY_HH
+#define TICKER_CXX_TICKER_WAIT_STRATEGY_HH
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+namespace ticker::pool {
+
+  /**
+     * @brief how the runner thread of timer_t waits for the next deadline.
+     */
+  enum class wait_strategy {
+    park,           // sleep on the Waiter until the deadline, the default
+    spin_then_park, // sleep until a spin window before the deadline, then spin
+    busy_poll,      // never sleep, for the pinned low-latency cores
+  };
+
+  /**
+     * @brief a hint to the CPU that we're in a spin loop.
+     */
+  inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield" ::: "memory");
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_pause();
+#endif
+  }
+
+  /**
+     * @brief measures how late a short sleep wakes up on this machine,
+     * which is the spin window spin_then_park needs.
+     * @return the worst oversleep of a few 100us sleeps, within [20us, 2ms]
+     */
+  inline std::chrono::nanoseconds calibrate_park_latency(int rounds = 8) {
+    using namespace std::literals::chrono_literals;
+    std::chrono::nanoseconds worst{};
+    for (int i = 0; i < rounds; i++) {
+      auto start = std::chrono::steady_clock::now();
+      std::this_thread::sleep_for(100us);
+      auto over = std::chrono::steady_clock::now() - start - 100us;
+      worst = std::max<std::chrono::nanoseconds>(worst, over);
+    }
+    return std::clamp<std::chrono::nanoseconds>(worst, 20us, 2ms);
+  }
+
+} // namespace ticker::pool
+
+#endif //TICKER_CXX_TICKER_WAIT_STRATEGY_HH
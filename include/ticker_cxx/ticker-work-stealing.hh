@@ -0,0 +1,309 @@
+// ticker_cxx Library
+// Copyright © 2021 Hedzr Yeh.
+//
+// This file is released under the terms of the MIT license.
+// Read /LICENSE for more information.
+
+//
+// Created by Hedzr Yeh on 2021/11/16.
+//
+
+#ifndef TICKER_CXX_TICKER_WORK_STEALING_HH
+#define TICKER_CXX_TICKER_WORK_STEALING_HH
+
+#include "ticker-def.hh"
+#include "ticker-executor.hh"
+#include "ticker-log.hh"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ticker::pool {
+
+  /**
+     * @brief the lock-free work-stealing deque of Chase and Lev, with the
+     * memory orders of Lê, Pop, Cohen and Zappa Nardelli (PPoPP 2013).
+     * @details The owner thread pushes and takes at the bottom (LIFO),
+     * the other threads steal from the top (FIFO). The ring doubles when
+     * it's full; a retired ring is kept until the deque is destroyed
+     * since a thief might still read from it.
+     * @tparam T a pointer type, nullptr means nothing
+     */
+  template<typename T>
+  class chase_lev_deque {
+    static_assert(std::is_pointer_v<T>, "chase_lev_deque: T must be a pointer");
+
+  public:
+    explicit chase_lev_deque(std::size_t capacity = 256) {
+      std::size_t n = 2;
+      while (n < capacity) n <<= 1;
+      _rings.emplace_back(std::make_unique<ring>(n));
+      _ring.store(_rings.back().get(), std::memory_order_relaxed);
+    }
+    chase_lev_deque(chase_lev_deque const &) = delete;
+    chase_lev_deque &operator=(chase_lev_deque const &) = delete;
+
+    // the owner only
+    void push(T x) {
+      auto b = _bottom.load(std::memory_order_relaxed);
+      auto t = _top.load(std::memory_order_acquire);
+      ring *a = _ring.load(std::memory_order_relaxed);
+      if (b - t > a->mask) a = grow(a, b, t);
+      a->put(b, x);
+      std::atomic_thread_fence(std::memory_order_release);
+      _bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    // the owner only, the newest one
+    T take() {
+      auto b = _bottom.load(std::memory_order_relaxed) - 1;
+      ring *a = _ring.load(std::memory_order_relaxed);
+      _bottom.store(b, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      auto t = _top.load(std::memory_order_relaxed);
+      T x = nullptr;
+      if (t <= b) {
+        x = a->get(b);
+        if (t == b) { // the last one, races with the thieves
+          if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            x = nullptr;
+          _bottom.store(b + 1, std::memory_order_relaxed);
+        }
+      } else {
+        _bottom.store(b + 1, std::memory_order_relaxed);
+      }
+      return x;
+    }
+    // any thread, the oldest one; nullptr if it's empty or another thread won it
+    T steal() {
+      auto t = _top.load(std::memory_order_acquire);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      auto b = _bottom.load(std::memory_order_acquire);
+      if (t < b) {
+        ring *a = _ring.load(std::memory_order_acquire);
+        T x = a->get(t);
+        if (_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+          return x;
+      }
+      return nullptr;
+    }
+
+    // a snapshot, exact for the owner only
+    bool empty() const { return _bottom.load(std::memory_order_relaxed) <= _top.load(std::memory_order_relaxed); }
+    std::size_t size() const {
+      auto n = _bottom.load(std::memory_order_relaxed) - _top.load(std::memory_order_relaxed);
+      return n > 0 ? std::size_t(n) : 0;
+    }
+
+  private:
+    struct ring {
+      explicit ring(std::size_t n)
+          : mask(std::int64_t(n) - 1)
+          , slots(new std::atomic<T>[n]) {}
+      T get(std::int64_t i) const { return slots[std::size_t(i & mask)].load(std::memory_order_relaxed); }
+      void put(std::int64_t i, T x) { slots[std::size_t(i & mask)].store(x, std::memory_order_relaxed); }
+      std::int64_t mask;
+      std::unique_ptr<std::atomic<T>[]> slots;
+    };
+    ring *grow(ring *a, std::int64_t b, std::int64_t t) {
+      auto r = std::make_unique<ring>(std::size_t(a->mask + 1) * 2);
+      for (auto i = t; i < b; ++i) r->put(i, a->get(i));
+      ring *p = r.get();
+      _rings.push_back(std::move(r));
+      _ring.store(p, std::memory_order_release);
+      return p;
+    }
+
+  private:
+    alignas(64) std::atomic<std::int64_t> _top{0};
+    alignas(64) std::atomic<std::int64_t> _bottom{0};
+    std::atomic<ring *> _ring{nullptr};
+    std::vector<std::unique_ptr<ring>> _rings{}; // the current ring and the retired ones, of the owner
+  }; // class chase_lev_deque
+
+  /**
+     * @brief a thread pool with a Chase-Lev deque per worker and
+     * randomized stealing.
+     * @details A task posted by a worker goes into its own deque, the
+     * worker runs its newest task first (hot in cache) and an idle
+     * worker steals the oldest task of a random victim. A task posted
+     * by another thread, such as the runner of a scheduler, is pushed
+     * onto a lock-free injection stack; the first worker looking for
+     * work moves the whole batch into its deque, where the others steal
+     * from. No lock is taken on the hot paths, the workers only park on
+     * a condition variable when there is nothing to run or steal.
+     *
+     * It's an executor, so a scheduler can run the jobs on it:
+     * @code{c++}
+     * auto s = std::make_shared<ticker::scheduler<>>(std::make_shared<ticker::pool::work_stealing_pool>(8));
+     * @endcode
+     * The tasks are not run in the order posted.
+     */
+  class work_stealing_pool {
+  public:
+    /**
+         * @param n the workers, zero or less for std::thread::hardware_concurrency()
+         */
+    explicit work_stealing_pool(int n = -1) {
+      std::size_t count = n > 0 ? std::size_t(n) : std::size_t(std::thread::hardware_concurrency());
+      if (count == 0) count = 1;
+      for (std::size_t i = 0; i < count; i++) _workers.emplace_back(std::make_unique<worker>(this));
+      for (std::size_t i = 0; i < count; i++) _workers[i]->t = std::thread([this, i] { run(i); });
+    }
+    CLAZZ_NON_COPYABLE(work_stealing_pool);
+    ~work_stealing_pool() { join(); }
+
+    /**
+         * @brief run task in the pool and forget it, see thread_pool::post().
+         */
+    template<class F>
+    void post(F &&task) { submit(new task_node{task_fn(std::forward<F>(task))}); }
+    template<class F>
+    void execute(F &&task) { post(std::forward<F>(task)); }
+    /**
+         * @brief run task in the pool, for the callers who need its result.
+         */
+    template<class F, class R = std::invoke_result_t<F>>
+    std::future<R> queue_task(F &&task) {
+      std::packaged_task<R()> p(std::forward<F>(task));
+      auto r = p.get_future();
+      post(std::move(p));
+      return r;
+    }
+
+    /**
+         * @brief stop the workers once the pending tasks have run.
+         */
+    void join() {
+      {
+        std::unique_lock<std::mutex> l(_m);
+        _stopping = true;
+      }
+      _cv.notify_all();
+      for (auto &w : _workers)
+        if (w->t.joinable()) w->t.join();
+    }
+    std::size_t total_threads() const { return _workers.size(); }
+    /**
+         * @brief the tasks a worker took from the deque of another
+         */
+    std::size_t steals() const { return _steals.load(std::memory_order_relaxed); }
+
+  private:
+    struct task_node {
+      task_fn fn;
+      task_node *next{nullptr}; // in the injection stack
+    };
+    struct worker {
+      explicit worker(work_stealing_pool *p)
+          : owner(p) {}
+      work_stealing_pool *owner;
+      chase_lev_deque<task_node *> q{};
+      std::thread t{};
+    };
+
+    void submit(task_node *n) {
+      if (_current && _current->owner == this) {
+        _current->q.push(n);
+      } else {
+        n->next = _inject.load(std::memory_order_relaxed);
+        while (!_inject.compare_exchange_weak(n->next, n, std::memory_order_seq_cst, std::memory_order_relaxed))
+          ;
+      }
+      // pairs with park(): either we see a sleeper, or it sees the task
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (_sleepers.load(std::memory_order_seq_cst) > 0) {
+        std::unique_lock<std::mutex> l(_m);
+        _cv.notify_one();
+      }
+    }
+
+    void run(std::size_t index) {
+      worker &w = *_workers[index];
+      _current = &w;
+      std::minstd_rand rng(std::uint_fast32_t(index * 7919 + 1));
+      for (;;) {
+        if (task_node *n = find_task(w, index, rng)) {
+          invoke(n);
+          continue;
+        }
+        if (!park()) break;
+      }
+      _current = nullptr;
+    }
+    task_node *find_task(worker &w, std::size_t index, std::minstd_rand &rng) {
+      if (task_node *n = w.q.take()) return n;
+      if (task_node *h = _inject.exchange(nullptr, std::memory_order_acquire)) {
+        // the oldest first: the stack is pushed into the (empty) deque
+        // newest first, so take() pops them back oldest first from the
+        // bottom, and the thieves steal the newest from the top. The
+        // oldest of all runs at once.
+        while (h->next) {
+          task_node *next = h->next; // a thief may run and free h once pushed
+          w.q.push(h);
+          h = next;
+        }
+        return h;
+      }
+      auto count = _workers.size();
+      auto from = std::size_t(rng()) % count;
+      for (std::size_t k = 0; k < count; k++) {
+        auto victim = (from + k) % count;
+        if (victim == index) continue;
+        if (task_node *n = _workers[victim]->q.steal()) {
+          _steals.fetch_add(1, std::memory_order_relaxed);
+          return n;
+        }
+      }
+      return nullptr;
+    }
+    void invoke(task_node *n) {
+      try {
+        n->fn();
+      } catch (std::exception const &e) {
+        dbg_print("[pool] a posted task threw: %s", e.what());
+      } catch (...) {
+        dbg_print("[pool] a posted task threw");
+      }
+      delete n;
+    }
+    // sleeps until a task is posted, returns false once stopping and no task is left
+    bool park() {
+      std::unique_lock<std::mutex> l(_m);
+      _sleepers.fetch_add(1, std::memory_order_seq_cst);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      while (!_stopping && !has_work())
+        _cv.wait(l);
+      _sleepers.fetch_sub(1, std::memory_order_relaxed);
+      return !_stopping || has_work();
+    }
+    bool has_work() const {
+      if (_inject.load(std::memory_order_seq_cst)) return true;
+      for (auto const &w : _workers)
+        if (!w->q.empty()) return true;
+      return false;
+    }
+
+  private:
+    std::vector<std::unique_ptr<worker>> _workers{};
+    std::atomic<task_node *> _inject{nullptr}; // the tasks posted by the other threads
+    std::atomic<std::size_t> _sleepers{0}, _steals{0};
+    std::mutex _m{};
+    std::condition_variable _cv{};
+    bool _stopping{false};
+    static inline thread_local worker *_current{nullptr}; // the worker of this thread
+  }; // class work_stealing_pool
+
+} // namespace ticker::pool
+
+#endif //TICKER_CXX_TICKER_WORK_STEALING_HH
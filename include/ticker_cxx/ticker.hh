@@ -30,10 +30,25 @@
 #include "ticker-x-class.hh"
 #include "ticker-x-test.hh"
 
+#include "ticker-affinity.hh"
 #include "ticker-anchors.hh"
+#include "ticker-dary-heap.hh"
+#include "ticker-executor.hh"
+#include "ticker-intrusive-list.hh"
 #include "ticker-jobs.hh"
+#include "ticker-mpsc-inbox.hh"
 #include "ticker-periodical-job.hh"
+#include "ticker-ringbuf.hh"
+#include "ticker-scheduler.hh"
+#include "ticker-slab.hh"
+#include "ticker-small-function.hh"
 #include "ticker-timer-job.hh"
+#include "ticker-timer-handle.hh"
+#include "ticker-timer-queue.hh"
+#include "ticker-timerfd.hh"
+#include "ticker-timing-wheel.hh"
+#include "ticker-wait-strategy.hh"
+#include "ticker-work-stealing.hh"
 
 #include "ticker-core.hh"
 
@@ -0,0 +1,206 @@
+// ticker_cxx Library
+// Copyright © 2021 Hedzr Yeh.
+//
+// This file is released under the terms of the MIT license.
+// Read /LICENSE for more information.
+
+//
+// Created by Hedzr Yeh on 2021/11/18.
+//
+
+// the CPU topology from sysfs, and the placement of the runner and the workers
+
+#include "ticker_cxx/ticker-affinity.hh"
+#include "ticker_cxx/ticker-core.hh"
+#include "ticker_cxx/ticker-log.hh"
+#include "ticker_cxx/ticker-pool.hh"
+#include "ticker_cxx/ticker-x-class.hh"
+#include "ticker_cxx/ticker-x-test.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+  ticker::debug::X x_global_var;
+
+  namespace fs = std::filesystem;
+
+  void write_file(fs::path const &p, std::string const &s) {
+    fs::create_directories(p.parent_path());
+    std::ofstream(p) << s << '\n';
+  }
+
+  void test_cpu_list() {
+    using ticker::pool::format_cpu_list;
+    using ticker::pool::parse_cpu_list;
+    if (parse_cpu_list("0-3,8,10-11") != std::vector<int>{0, 1, 2, 3, 8, 10, 11} ||
+        format_cpu_list({0, 1, 2, 3, 8, 10, 11}) != "0-3,8,10-11" ||
+        parse_cpu_list("5\n") != std::vector<int>{5}) {
+      dbg_print("ERROR: expecting a CPU list parsed and formatted back");
+      exit(-1);
+    }
+    if (!parse_cpu_list("3-1").empty() || !parse_cpu_list("x").empty() || !parse_cpu_list("").empty()) {
+      dbg_print("ERROR: expecting a malformed CPU list parsed empty");
+      exit(-1);
+    }
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+  void test_topology() {
+    auto root = fs::temp_directory_path() / ("ticker-affinity-" + std::to_string(::getpid()));
+    write_file(root / "numa" / "node" / "node0" / "cpulist", "0-1");
+    write_file(root / "numa" / "node" / "node1" / "cpulist", "2-3");
+    write_file(root / "numa" / "node" / "node2" / "cpulist", ""); // memory only
+    write_file(root / "numa" / "node" / "node3" / "cpulist", "4-5");
+    write_file(root / "numa" / "node" / "possible", "0-3");
+    write_file(root / "flat" / "cpu" / "online", "0-5");
+
+    auto t = ticker::pool::cpu_topology::detect((root / "numa").string());
+    if (t.nodes.size() != 3 || t.cpu_count() != 6 || t.ids != std::vector<int>{0, 1, 3} || t.node_of(3) != 1 ||
+        t.node_of(5) != 3 || t.node_of(9) != -1 || t.cpus_of(3) != std::vector<int>{4, 5} || !t.cpus_of(2).empty()) {
+      dbg_print("ERROR: expecting the nodes 0, 1 and 3 of 2 CPUs, got %zu nodes", t.nodes.size());
+      exit(-1);
+    }
+    auto flat = ticker::pool::cpu_topology::detect((root / "flat").string());
+    if (flat.nodes.size() != 1 || flat.cpu_count() != 6 || flat.ids != std::vector<int>{0}) {
+      dbg_print("ERROR: expecting 1 node of cpu/online, got %zu nodes", flat.nodes.size());
+      exit(-1);
+    }
+    fs::remove_all(root);
+
+    ticker::pool::placement where;
+    // nothing read from sysfs until resolve(), nothing placed without a topology
+    if (where.topology || !where.worker_cpus(0).empty()) {
+      dbg_print("ERROR: expecting the topology detected only by resolve()");
+      exit(-1);
+    }
+    where.topology = t;
+    if (where.resolve().nodes != t.nodes) {
+      dbg_print("ERROR: expecting resolve() to keep the given topology");
+      exit(-1);
+    }
+    if (where.worker_cpus(0) != t.nodes[0] || where.worker_cpus(1) != t.nodes[1] || where.worker_cpus(2) != t.nodes[2] ||
+        where.worker_cpus(3) != t.nodes[0] || !where.runner_cpus().empty()) {
+      dbg_print("ERROR: expecting the workers spread over the nodes, and the runner left");
+      exit(-1);
+    }
+    where.node = 1, where.runner_cpu = 3;
+    if (where.worker_cpus(0) != t.nodes[1] || where.runner_cpus() != std::vector<int>{3}) {
+      dbg_print("ERROR: expecting the workers on node 1, the runner on CPU 3");
+      exit(-1);
+    }
+    // by the kernel id, not the index: node 3 is nodes[2], node 2 has no CPU
+    where.node = 3, where.runner_cpu = -1;
+    if (where.worker_cpus(0) != std::vector<int>{4, 5} || where.runner_cpus() != std::vector<int>{4, 5}) {
+      dbg_print("ERROR: expecting the workers and the runner on the CPUs of node 3");
+      exit(-1);
+    }
+    where.node = 2;
+    if (!where.worker_cpus(0).empty() || !where.runner_cpus().empty()) {
+      dbg_print("ERROR: expecting nothing placed on the memory-only node 2");
+      exit(-1);
+    }
+
+    auto real = ticker::pool::cpu_topology::detect();
+    printf("  - this host: %zu nodes, %zu cpus\n", real.nodes.size(), real.cpu_count());
+    if (real.nodes.empty() || real.cpu_count() == 0) {
+      dbg_print("ERROR: expecting at least one CPU on this host");
+      exit(-1);
+    }
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+#if defined(__linux__)
+  std::vector<int> current_affinity() {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    std::vector<int> cpus;
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+      for (int c = 0; c < CPU_SETSIZE; c++)
+        if (CPU_ISSET(c, &set)) cpus.push_back(c);
+    return cpus;
+  }
+#endif
+
+  void test_scheduler_placement() {
+    using namespace std::literals::chrono_literals;
+    ticker::pool::placement where;
+    where.node = where.resolve().ids[0];
+    auto node_cpus = where.topology->nodes[0];
+    auto s = std::make_shared<ticker::scheduler<>>(2, where);
+    auto report = s->placement();
+    if (!report) {
+      dbg_print("ERROR: expecting a placement report");
+      exit(-1);
+    }
+    printf("%s", report->to_string().c_str());
+    auto entries = report->entries();
+    bool runner = std::any_of(entries.begin(), entries.end(), [](auto const &e) { return e.thread == "runner"; });
+    if (!runner || entries.size() != 3) {
+      dbg_print("ERROR: expecting the runner and 2 workers placed, got %zu", entries.size());
+      exit(-1);
+    }
+    for (auto const &e : entries) {
+      if (e.cpus != node_cpus || e.node != where.node) {
+        dbg_print("ERROR: expecting %s on node %d", e.thread.c_str(), where.node);
+        exit(-1);
+      }
+#if defined(__linux__)
+      if (!e.applied) {
+        dbg_print("ERROR: expecting %s pinned", e.thread.c_str());
+        exit(-1);
+      }
+#endif
+    }
+
+    // the jobs run on the CPUs of the node
+    auto t = ticker::timer_t<>::get(s);
+    ticker::pool::conditional_wait_for_int count{1};
+    std::vector<int> job_cpus;
+    t->after(1ms).on([&count, &job_cpus] {
+                   ticker::pool::cw_setter const cws(count);
+#if defined(__linux__)
+                   job_cpus = current_affinity();
+#endif
+                 })
+        .build();
+    if (!count.wait_for(2s)) {
+      dbg_print("ERROR: expecting the job run on the placed pool");
+      exit(-1);
+    }
+#if defined(__linux__)
+    if (job_cpus != node_cpus) {
+      dbg_print("ERROR: expecting the job run on the CPUs %s, got %s",
+                ticker::pool::format_cpu_list(node_cpus).c_str(), ticker::pool::format_cpu_list(job_cpus).c_str());
+      exit(-1);
+    }
+#endif
+
+    // no placement, no report
+    if (ticker::pool::thread_pool(1).placement()) {
+      dbg_print("ERROR: expecting no report without a placement");
+      exit(-1);
+    }
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+} // namespace
+
+int main() {
+  TICKER_TEST_FOR(test_cpu_list);
+  TICKER_TEST_FOR(test_topology);
+  TICKER_TEST_FOR(test_scheduler_placement);
+}
@@ -0,0 +1,140 @@
+// ticker_cxx Library
+// Copyright © 2021 Hedzr Yeh.
+//
+// This file is released under the terms of the MIT license.
+// Read /LICENSE for more information.
+
+//
+// Created by Hedzr Yeh on 2021/11/06.
+//
+
+// the contention of scheduling timers from many producer threads
+
+#include "ticker_cxx/ticker-chrono.hh"
+#include "ticker_cxx/ticker-core.hh"
+#include "ticker_cxx/ticker-log.hh"
+#include "ticker_cxx/ticker-timer-handle.hh"
+#include "ticker_cxx/ticker-x-class.hh"
+#include "ticker_cxx/ticker-x-test.hh"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+  ticker::debug::X x_global_var;
+
+  const int per_producer = 1000;
+  const int producer_counts[] = {1, 2, 4, 8, 16, 32, 64};
+
+  template<typename F>
+  double run_producers(int producers, F &&submit) {
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+      threads.emplace_back([&go, &submit] {
+        while (!go.load()) std::this_thread::yield();
+        for (int i = 0; i < per_producer; i++) submit(i);
+      });
+    }
+    auto start = std::chrono::steady_clock::now();
+    go = true;
+    for (auto &t : threads) t.join();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return double(producers * per_producer) / elapsed.count();
+  }
+
+  // the former add_task(): a mutex shared with the runner, plus a yield
+  void bench_locked_baseline() {
+    using namespace std::literals::chrono_literals;
+    for (auto producers : producer_counts) {
+      std::mutex m;
+      ticker::queue::map_queue<ticker::Clock, int> q;
+      auto base = ticker::Clock::now() + 1h;
+      double rate = run_producers(producers, [&](int i) {
+        {
+          std::unique_lock<std::mutex> l(m);
+          q.add(base + std::chrono::microseconds(i), int(i));
+        }
+        std::this_thread::yield();
+      });
+      printf("  - mutex + yield  %3d producers: %12.0f adds/s\n", producers, rate);
+    }
+  }
+
+  // the submission path of add_task() now
+  void bench_mpsc_inbox() {
+    using namespace std::literals::chrono_literals;
+    for (auto producers : producer_counts) {
+      ticker::queue::mpsc_inbox<std::pair<ticker::Clock::time_point, int>> inbox;
+      auto base = ticker::Clock::now() + 1h;
+      double rate = run_producers(producers, [&](int i) {
+        inbox.push({base + std::chrono::microseconds(i), int(i)});
+      });
+      std::size_t count = inbox.drain([](auto &&) {});
+      if (count != std::size_t(producers * per_producer)) {
+        dbg_print("ERROR: %zu items drained", count);
+        exit(-1);
+      }
+      printf("  - mpsc inbox     %3d producers: %12.0f adds/s\n", producers, rate);
+    }
+  }
+
+  // the handle of each build(): a slot popped off the lock-free free
+  // list, recorded to the owner under its mutex, pushed back on firing
+  void bench_job_registry() {
+    for (bool shared : {false, true}) {
+      for (auto producers : producer_counts) {
+        ticker::detail::job_registry reg;
+        ticker::detail::job_owner one;
+        double rate = run_producers(producers, [&](int) {
+          thread_local ticker::job_base j;
+          thread_local ticker::detail::job_owner own;
+          reg.attach(j, shared ? &one : &own);
+          reg.release(j);
+        });
+        if (reg.size() != 0) {
+          dbg_print("ERROR: %zu handles left pending", reg.size());
+          exit(-1);
+        }
+        printf("  - %s %3d producers: %12.0f attaches/s\n", shared ? "one owner      " : "owner / thread ", producers, rate);
+      }
+    }
+  }
+
+  // end to end: make the job, attach a handle and push it
+  void bench_timer_schedule() {
+    using namespace std::literals::chrono_literals;
+    for (auto producers : producer_counts) {
+      std::atomic<int> fired{0};
+      auto t = ticker::timer_t<>::get();
+      auto due = ticker::Clock::now() + 50ms;
+      double rate = run_producers(producers, [&](int i) {
+        t->schedule(due + std::chrono::microseconds(i), [&fired] { fired++; });
+      });
+      printf("  - timer schedule %3d producers: %12.0f adds/s\n", producers, rate);
+
+      // every scheduled job must fire
+      const int total = producers * per_producer;
+      for (int retry = 0; retry < 500 && fired.load() < total; retry++)
+        std::this_thread::sleep_for(10ms);
+      if (fired.load() != total) {
+        dbg_print("ERROR: %d of %d jobs fired", fired.load(), total);
+        exit(-1);
+      }
+    }
+  }
+
+} // namespace
+
+int main() {
+  TICKER_TEST_FOR(bench_locked_baseline);
+  TICKER_TEST_FOR(bench_mpsc_inbox);
+  TICKER_TEST_FOR(bench_job_registry);
+  TICKER_TEST_FOR(bench_timer_schedule);
+}
@@ -0,0 +1,97 @@
+// ticker_cxx Library
+// Copyright © 2021 Hedzr Yeh.
+//
+// This file is released under the terms of the MIT license.
+// Read /LICENSE for more information.
+
+//
+// Created by Hedzr Yeh on 2021/11/08.
+//
+
+// the lateness of the fired timers, for each runner backend and wait strategy
+
+#include "ticker_cxx/ticker-chrono.hh"
+#include "ticker_cxx/ticker-core.hh"
+#include "ticker_cxx/ticker-log.hh"
+#include "ticker_cxx/ticker-x-class.hh"
+#include "ticker_cxx/ticker-x-test.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace {
+
+  ticker::debug::X x_global_var;
+
+  // each timer needs a wakeup of its own
+  const int count = 1000;
+  const auto gap = std::chrono::microseconds(500);
+
+  template<typename Timer>
+  void measure(const char *name, ticker::pool::wait_strategy strategy = ticker::pool::wait_strategy::park) {
+    using namespace std::literals::chrono_literals;
+    std::vector<std::chrono::nanoseconds> lateness(count);
+    ticker::pool::conditional_wait_for_int done{count};
+    auto t = Timer::get();
+    t->wait_strategy(strategy);
+
+    auto start = ticker::Clock::now() + 20ms;
+    for (int i = 0; i < count; i++) {
+      auto tp = start + gap * i;
+      t->at(tp)
+          .on([&done, &lateness, tp, i] {
+            lateness[i] = ticker::Clock::now() - tp;
+            ticker::pool::cw_setter const cws(done);
+          })
+          .build();
+    }
+    done.wait();
+
+    std::sort(lateness.begin(), lateness.end());
+    if (lateness.front() < std::chrono::nanoseconds::zero()) {
+      dbg_print("ERROR: %s: a timer fired early", name);
+      exit(-1);
+    }
+    auto us = [](std::chrono::nanoseconds d) { return double(d.count()) / 1e3; };
+    printf("  - %-24s p50: %8.1fus, p99: %8.1fus, p999: %8.1fus, max: %8.1fus (spin window: %.1fus)\n", name,
+           us(lateness[count / 2]), us(lateness[count * 99 / 100]), us(lateness[count * 999 / 1000]), us(lateness.back()),
+           us(t->spin_window()));
+  }
+
+  // the runner spins on a core, the pool workers need another one
+  bool spare_core() {
+    if (std::thread::hardware_concurrency() > 1) return true;
+    printf("  - busy_poll skipped: a single core\n");
+    return false;
+  }
+
+  void bench_condvar() {
+    measure<ticker::timer_t<>>("condvar park");
+    measure<ticker::timer_t<>>("condvar spin_then_park", ticker::pool::wait_strategy::spin_then_park);
+    if (spare_core())
+      measure<ticker::timer_t<>>("condvar busy_poll", ticker::pool::wait_strategy::busy_poll);
+  }
+
+#if TICKER_CXX_HAS_TIMERFD
+  void bench_timerfd() {
+    using fd_timer = ticker::timer_t<std::nullopt_t, ticker::Clock, false,
+                                     ticker::detail::in_job<ticker::Clock, false>,
+                                     ticker::queue::map_policy,
+                                     ticker::pool::timerfd_waiter>;
+    measure<fd_timer>("timerfd park");
+    measure<fd_timer>("timerfd spin_then_park", ticker::pool::wait_strategy::spin_then_park);
+  }
+#endif
+
+} // namespace
+
+int main() {
+  TICKER_TEST_FOR(bench_condvar);
+#if TICKER_CXX_HAS_TIMERFD
+  TICKER_TEST_FOR(bench_timerfd);
+#endif
+}
@@ -0,0 +1,93 @@
+// ticker_cxx Library
+// Copyright © 2021 Hedzr Yeh.
+//
+// This file is released under the terms of the MIT license.
+// Read /LICENSE for more information.
+
+//
+// Created by Hedzr Yeh on 2021/11/07.
+//
+
+// restoring a lot of timers: the fluent chain per job vs. schedule_many()
+
+#include "ticker_cxx/ticker-chrono.hh"
+#include "ticker_cxx/ticker-core.hh"
+#include "ticker_cxx/ticker-log.hh"
+#include "ticker_cxx/ticker-x-class.hh"
+#include "ticker_cxx/ticker-x-test.hh"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <vector>
+
+namespace {
+
+  ticker::debug::X x_global_var;
+
+  const int count = 200000;
+
+  using items_t = std::vector<std::pair<ticker::Clock::time_point, std::function<void()>>>;
+
+  // random deadlines over the next few hours, none fires during the bench
+  items_t make_items() {
+    using namespace std::literals::chrono_literals;
+    std::mt19937_64 rng(20211107);
+    std::uniform_int_distribution<std::int64_t> dist(0, std::chrono::milliseconds(3h).count());
+    auto base = ticker::Clock::now() + 1h;
+    items_t items;
+    items.reserve(count);
+    for (int i = 0; i < count; i++)
+      items.emplace_back(base + std::chrono::milliseconds(dist(rng)), [] {});
+    return items;
+  }
+
+  template<typename Timer>
+  void check_pending(Timer &t, const char *name, double secs) {
+    printf("  - %-24s %d jobs: %8.1f ms, %10.0f jobs/s\n", name, count, secs * 1e3, count / secs);
+    if (t->pending_handles() != std::size_t(count)) {
+      dbg_print("ERROR: expecting %d pending jobs but got %zu", count, t->pending_handles());
+      exit(-1);
+    }
+  }
+
+  template<typename Timer>
+  void bench_policy(const char *per_call, const char *batch) {
+    {
+      auto items = make_items();
+      auto t = Timer::get();
+      auto start = std::chrono::steady_clock::now();
+      for (auto &it : items)
+        t->at(it.first).on(std::move(it.second)).build();
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      check_pending(t, per_call, elapsed.count());
+    }
+    {
+      auto items = make_items();
+      auto t = Timer::get();
+      auto start = std::chrono::steady_clock::now();
+      t->schedule_many(std::move(items));
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      check_pending(t, batch, elapsed.count());
+    }
+  }
+
+  void bench_map_queue() {
+    bench_policy<ticker::timer_t<>>("map: at().on().build()", "map: schedule_many()");
+  }
+
+  void bench_heap_queue() {
+    using heap_timer = ticker::timer_t<std::nullopt_t, ticker::Clock, false,
+                                       ticker::detail::in_job<ticker::Clock, false>,
+                                       ticker::queue::heap_policy<>>;
+    bench_policy<heap_timer>("heap: at().on().build()", "heap: schedule_many()");
+  }
+
+} // namespace
+
+int main() {
+  TICKER_TEST_FOR(bench_map_queue);
+  TICKER_TEST_FOR(bench_heap_queue);
+}
@@ -0,0 +1,156 @@
+// ticker_cxx Library
+// Copyright © 2021 Hedzr Yeh.
+//
+// This file is released under the terms of the MIT license.
+// Read /LICENSE for more information.
+
+//
+// Created by Hedzr Yeh on 2021/11/15.
+//
+
+// the type-erased jobs against the statically dispatched ones
+
+#include "ticker_cxx/ticker-chrono.hh"
+#include "ticker_cxx/ticker-core.hh"
+#include "ticker_cxx/ticker-executor.hh"
+#include "ticker_cxx/ticker-log.hh"
+#include "ticker_cxx/ticker-x-class.hh"
+#include "ticker_cxx/ticker-x-test.hh"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace {
+
+  ticker::debug::X x_global_var;
+
+  using every_t = ticker::detail::every_job<>;
+
+  // the recurrence of n jobs computed rounds times, held as J, and
+  // called by the qualified name of a concrete J as the runner does
+  template<typename J>
+  double bench_next_time_point(std::vector<J> const &jobs, int rounds) {
+    using E = typename J::element_type;
+    auto now = ticker::Clock::now();
+    auto sum = ticker::Clock::duration::zero();
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+      now += std::chrono::milliseconds(1);
+      for (auto const &j : jobs) {
+        if constexpr (std::is_same_v<E, ticker::timer_job>)
+          sum += j->next_time_point(now).time_since_epoch();
+        else
+          sum += j->E::next_time_point(now).time_since_epoch();
+      }
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    if (sum == ticker::Clock::duration::zero()) exit(-1); // keeps the loop
+    return elapsed.count() / double(rounds * jobs.size());
+  }
+
+  void bench_dispatch() {
+    using namespace std::literals::chrono_literals;
+    const int n = 1024, rounds = 1000;
+    std::vector<std::shared_ptr<ticker::timer_job>> erased;
+    std::vector<std::shared_ptr<every_t>> concrete;
+    for (int i = 0; i < n; i++) {
+      // fixed rate, the fixed-delay path logs in the debug builds
+      auto j = std::make_shared<every_t>(1ms, [] {});
+      j->fixed_rate(ticker::misfire::coalesce);
+      concrete.push_back(j);
+      auto k = std::make_shared<every_t>(1ms, [] {});
+      k->fixed_rate(ticker::misfire::coalesce);
+      erased.push_back(std::move(k));
+    }
+    printf("  - %-40s %8.2f ns/job\n", "next_time_point(), basic_timer_job", bench_next_time_point(erased, rounds));
+    printf("  - %-40s %8.2f ns/job\n", "next_time_point(), every_job", bench_next_time_point(concrete, rounds));
+  }
+
+  // the runner firing n one-shot jobs, all of them due at once
+  template<typename Timer>
+  double bench_runner(int n) {
+    using namespace std::literals::chrono_literals;
+    auto t = Timer::get(std::make_shared<ticker::pool::inline_executor>());
+    ticker::pool::conditional_wait_for_int count{n};
+    std::vector<std::pair<ticker::Clock::time_point, std::function<void()>>> items;
+    auto due = ticker::Clock::now() + 20ms;
+    for (int i = 0; i < n; i++)
+      items.emplace_back(due, [&count] { ticker::pool::cw_setter const cws(count); });
+    t->schedule_many(std::move(items));
+    std::this_thread::sleep_until(due);
+    auto start = std::chrono::steady_clock::now();
+    count.wait();
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / n;
+  }
+
+  void bench_runner_fire() {
+    const int n = 20000;
+    bench_runner<ticker::timer_t<>>(n / 10); // warm up
+    printf("  - %-40s %8.2f ns/job\n", "runner, timer_t<>", bench_runner<ticker::timer_t<>>(n));
+    printf("  - %-40s %8.2f ns/job\n", "runner, static_timer", bench_runner<ticker::static_timer>(n));
+  }
+
+  void test_static_ticker() {
+    using namespace std::literals::chrono_literals;
+    static_assert(std::is_same_v<ticker::static_ticker::scheduler_type::Job, every_t>);
+    static_assert(std::is_same_v<ticker::ticker_t<>::scheduler_type::Job, ticker::timer_job>);
+
+    ticker::pool::conditional_wait_for_int count{8};
+    auto t = ticker::static_ticker::get();
+    t->every(1ms).fixed_rate().on([&count] { ticker::pool::cw_setter const cws(count); }).build();
+    auto k = ticker::static_ticker::get();
+    k->interval(1ms).on([&count] { ticker::pool::cw_setter const cws(count); }).build();
+    if (!count.wait_for(2s)) {
+      dbg_print("ERROR: expecting the static tickers tick, %d ticks left", count.val());
+      exit(-1);
+    }
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+  // a job derived from every_job, which counts its recurrences
+  struct counted_every : every_t {
+    using every_t::every_t;
+    using every_t::next_time_point;
+    ticker::Clock::time_point next_time_point(ticker::Clock::time_point const now) const override {
+      ++recurrences;
+      return every_t::next_time_point(now);
+    }
+    static inline std::atomic<int> recurrences{0};
+  };
+
+  template<typename Ticker>
+  void run_counted(const char *name) {
+    using namespace std::literals::chrono_literals;
+    counted_every::recurrences = 0;
+    ticker::pool::conditional_wait_for_int count{4};
+    auto t = Ticker::get();
+    t->every(1ms).on([&count] { ticker::pool::cw_setter const cws(count); }).build();
+    if (!count.wait_for(2s) || counted_every::recurrences.load() < 3) {
+      dbg_print("ERROR: %s: expecting the derived job recurs by its own next_time_point(), %d times", name, counted_every::recurrences.load());
+      exit(-1);
+    }
+  }
+
+  void test_derived_job() {
+    run_counted<ticker::ticker_t<std::nullopt_t, ticker::Clock, false, counted_every>>("ticker_t<counted_every>");
+    run_counted<ticker::ticker_t<std::nullopt_t, ticker::Clock, false, ticker::static_job<counted_every>>>("ticker_t<static_job<counted_every>>");
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+} // namespace
+
+int main() {
+  TICKER_TEST_FOR(bench_dispatch);
+  TICKER_TEST_FOR(bench_runner_fire);
+  TICKER_TEST_FOR(test_static_ticker);
+  TICKER_TEST_FOR(test_derived_job);
+}
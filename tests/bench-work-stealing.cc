@@ -0,0 +1,182 @@
+// ticker_cxx Library
+// Copyright © 2021 Hedzr Yeh.
+//
+// This file is released under the terms of the MIT license.
+// Read /LICENSE for more information.
+
+//
+// Created by Hedzr Yeh on 2021/11/16.
+//
+
+// the fan-out of tasks over 1 to 64 workers: thread_pool, thread_pool_lite
+// and work_stealing_pool
+
+#include "ticker_cxx/ticker-core.hh"
+#include "ticker_cxx/ticker-log.hh"
+#include "ticker_cxx/ticker-pool.hh"
+#include "ticker_cxx/ticker-work-stealing.hh"
+#include "ticker_cxx/ticker-x-class.hh"
+#include "ticker_cxx/ticker-x-test.hh"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+  ticker::debug::X x_global_var;
+
+  const int worker_counts[] = {1, 2, 4, 8, 16, 32, 64};
+  const int tasks = 20000;
+
+  // a small piece of work, as a timer callback
+  void spin(std::atomic<int> &done) {
+    volatile unsigned x = 0;
+    for (int i = 0; i < 200; i++) x = x + unsigned(i);
+    done.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void wait_all(std::atomic<int> &done, int n, const char *name) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (done.load() < n) {
+      if (std::chrono::steady_clock::now() > deadline) {
+        dbg_print("ERROR: %s: %d of %d tasks ran", name, done.load(), n);
+        exit(-1);
+      }
+      std::this_thread::yield();
+    }
+  }
+
+  struct use_thread_pool {
+    static constexpr const char *name = "thread_pool";
+    explicit use_thread_pool(int n)
+        : p(n) {}
+    template<typename F>
+    void submit(F &&f) { p.post(std::forward<F>(f)); }
+    ticker::pool::thread_pool p;
+  };
+  struct use_thread_pool_lite {
+    static constexpr const char *name = "thread_pool_lite";
+    explicit use_thread_pool_lite(int n)
+        : p(std::size_t(n)) {}
+    template<typename F>
+    void submit(F &&f) { p.enqueue(std::forward<F>(f)); }
+    ticker::pool::thread_pool_lite p;
+  };
+  struct use_work_stealing {
+    static constexpr const char *name = "work_stealing_pool";
+    explicit use_work_stealing(int n)
+        : p(n) {}
+    template<typename F>
+    void submit(F &&f) { p.post(std::forward<F>(f)); }
+    ticker::pool::work_stealing_pool p;
+  };
+
+  // tasks posted by one outside thread, as the runner fires a burst of timers
+  template<typename Pool>
+  double fan_out(int workers) {
+    Pool pool(workers);
+    std::atomic<int> done{0};
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < tasks; i++)
+      pool.submit([&done] { spin(done); });
+    wait_all(done, tasks, Pool::name);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return tasks / elapsed.count();
+  }
+
+  // the tasks post their subtasks from the workers
+  template<typename Pool>
+  double nested(int workers) {
+    const int roots = 100, children = tasks / roots - 1;
+    Pool pool(workers);
+    std::atomic<int> done{0};
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < roots; i++) {
+      pool.submit([&pool, &done] {
+        for (int c = 0; c < children; c++)
+          pool.submit([&done] { spin(done); });
+        spin(done);
+      });
+    }
+    wait_all(done, roots * (children + 1), Pool::name);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return tasks / elapsed.count();
+  }
+
+  template<typename Pool>
+  void bench_pool() {
+    for (auto n : worker_counts) {
+      auto a = fan_out<Pool>(n);
+      auto b = nested<Pool>(n);
+      printf("  - %-20s %3d workers: fan-out %10.0f tasks/s, nested %10.0f tasks/s\n", Pool::name, n, a, b);
+    }
+  }
+
+  void bench_thread_pool() { bench_pool<use_thread_pool>(); }
+  void bench_thread_pool_lite() { bench_pool<use_thread_pool_lite>(); }
+  void bench_work_stealing_pool() { bench_pool<use_work_stealing>(); }
+
+  // the tasks posted from outside run in the order posted, on one worker
+  void test_work_stealing_fifo() {
+    const int n = 64;
+    ticker::pool::work_stealing_pool pool(1);
+    std::atomic<bool> started{false}, open{false};
+    pool.post([&] {
+      started = true;
+      while (!open) std::this_thread::yield();
+    });
+    while (!started) std::this_thread::yield();
+
+    ticker::pool::conditional_wait_for_int count{n};
+    std::vector<int> order;
+    for (int i = 0; i < n; i++)
+      pool.post([&count, &order, i] {
+        ticker::pool::cw_setter const cws(count);
+        order.push_back(i);
+      });
+    open = true;
+    count.wait();
+    for (int i = 0; i < n; i++) {
+      if (order[std::size_t(i)] != i) {
+        dbg_print("ERROR: expecting the injected tasks run FIFO, task %d ran at %d", order[std::size_t(i)], i);
+        exit(-1);
+      }
+    }
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+  void test_work_stealing_timer() {
+    using namespace std::literals::chrono_literals;
+    auto pool = std::make_shared<ticker::pool::work_stealing_pool>(4);
+    auto t = ticker::timer_t<>::get(pool);
+    ticker::pool::conditional_wait_for_int count{100};
+    auto due = ticker::Clock::now() + 5ms;
+    for (int i = 0; i < 100; i++)
+      t->schedule(due, [&count] { ticker::pool::cw_setter const cws(count); });
+    if (!count.wait_for(5s)) {
+      dbg_print("ERROR: expecting the jobs run on the work_stealing_pool, %d left", count.val());
+      exit(-1);
+    }
+    auto f = pool->queue_task([] { return 42; });
+    if (f.get() != 42) {
+      dbg_print("ERROR: expecting queue_task() returns the result");
+      exit(-1);
+    }
+    printf("  - %zu steals\n", pool->steals());
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+} // namespace
+
+int main() {
+  TICKER_TEST_FOR(bench_thread_pool);
+  TICKER_TEST_FOR(bench_thread_pool_lite);
+  TICKER_TEST_FOR(bench_work_stealing_pool);
+  TICKER_TEST_FOR(test_work_stealing_fifo);
+  TICKER_TEST_FOR(test_work_stealing_timer);
+}
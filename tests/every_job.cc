@@ -0,0 +1,156 @@
+// ticker_cxx Library
+// Copyright © 2021 Hedzr Yeh.
+//
+// This file is released under the terms of the MIT license.
+// Read /LICENSE for more information.
+
+//
+// Created by Hedzr Yeh on 2021/11/10.
+//
+
+#include "ticker_cxx/ticker-jobs.hh"
+#include "ticker_cxx/ticker-log.hh"
+#include "ticker_cxx/ticker-x-class.hh"
+#include "ticker_cxx/ticker-x-test.hh"
+
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+  ticker::debug::X x_global_var;
+
+  // a manual clock, so an hour of ticks runs in no time
+  struct fake_clock {
+    using duration = std::chrono::nanoseconds;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<fake_clock>;
+    static constexpr bool is_steady = true;
+    static time_point now() noexcept { return _now; }
+    static inline time_point _now{std::chrono::hours(24 * 365 * 50)};
+  };
+
+  using job_t = ticker::detail::every_job<fake_clock>;
+  using tp_t = fake_clock::time_point;
+
+  // schedules j as build() and the scheduler do: the first period by
+  // the query, then advance() on each firing at now
+  tp_t first_due(job_t &j, tp_t start) {
+    j.due(j.next_time_point(start));
+    return j.due();
+  }
+  tp_t fire(job_t &j, tp_t now) {
+    j.due(j.advance(now));
+    return j.due();
+  }
+
+  // fires a 1s job for a number of ticks, each dispatch 0-5ms late
+  tp_t run_ticks(job_t &j, tp_t start, int ticks, bool check_grid) {
+    using namespace std::literals::chrono_literals;
+    std::mt19937_64 rng(20211110);
+    std::uniform_int_distribution<std::int64_t> latency(0, std::chrono::nanoseconds(5ms).count());
+    auto due = first_due(j, start);
+    for (int i = 1; i < ticks; i++) {
+      if (check_grid && due != start + std::chrono::seconds(i)) {
+        dbg_print("ERROR: tick %d is off the grid by %ld ns", i, long((due - start - std::chrono::seconds(i)).count()));
+        exit(-1);
+      }
+      due = fire(j, due + std::chrono::nanoseconds(latency(rng)));
+    }
+    return due;
+  }
+
+  void test_every_job_drift() {
+    using namespace std::literals::chrono_literals;
+    const auto start = fake_clock::now();
+
+    // 10 minutes is enough, the fixed-delay path logs each tick
+    job_t fixed_delay(1s, [] {});
+    auto drifted = run_ticks(fixed_delay, start, 600, false) - (start + 600s);
+    dbg_print("  - fixed delay drifts %.3f s in 10 minutes", std::chrono::duration<double>(drifted).count());
+    if (drifted < 1s) {
+      dbg_print("ERROR: expecting a fixed-delay job drifts, but it drifted %ld ns", long(drifted.count()));
+      exit(-1);
+    }
+
+    job_t fixed_rate(1s, [] {});
+    fixed_rate.fixed_rate(ticker::misfire::coalesce);
+    auto last = run_ticks(fixed_rate, start, 3600, true);
+    if (last != start + 3600s) {
+      dbg_print("ERROR: expecting the 3600th tick at +3600s, but it's off by %ld ns", long((last - start - 3600s).count()));
+      exit(-1);
+    }
+  }
+
+  // the ticks fired within a stall of 10.5s after the one due at start + 1s
+  std::vector<tp_t> stall(ticker::misfire policy, tp_t start) {
+    using namespace std::literals::chrono_literals;
+    job_t j(1s, [] {});
+    j.fixed_rate(policy);
+    auto due = first_due(j, start);
+    auto now = due + 10500ms;
+    std::vector<tp_t> fired;
+    // whatever is due by now fires at once, back to back
+    for (due = fire(j, now); due <= now; due = fire(j, now))
+      fired.push_back(due);
+    fired.push_back(due); // the first one after the stall
+    return fired;
+  }
+
+  void test_every_job_misfire() {
+    using namespace std::literals::chrono_literals;
+    const auto start = fake_clock::now();
+    const auto resume = start + 12s; // the grid point right after the stall
+
+    auto all = stall(ticker::misfire::fire_all, start);
+    if (all.size() != 11 || all.back() != resume) {
+      dbg_print("ERROR: fire_all: expecting 10 catch-up ticks, got %zu", all.size() - 1);
+      exit(-1);
+    }
+    for (std::size_t i = 0; i + 1 < all.size(); i++) {
+      if (all[i] != start + std::chrono::seconds(i + 2)) {
+        dbg_print("ERROR: fire_all: catch-up tick %zu is off the grid", i);
+        exit(-1);
+      }
+    }
+
+    auto coalesced = stall(ticker::misfire::coalesce, start);
+    if (coalesced.size() != 2 || coalesced[0] != start + 11s || coalesced[1] != resume) {
+      dbg_print("ERROR: coalesce: expecting 1 catch-up tick, got %zu", coalesced.size() - 1);
+      exit(-1);
+    }
+
+    auto skipped = stall(ticker::misfire::skip, start);
+    if (skipped.size() != 1 || skipped[0] != resume) {
+      dbg_print("ERROR: skip: expecting no catch-up tick, got %zu", skipped.size() - 1);
+      exit(-1);
+    }
+  }
+
+  // next_time_point() is a query: asking for it, as a log line does,
+  // doesn't move a fixed-rate job on
+  void test_every_job_query() {
+    using namespace std::literals::chrono_literals;
+    const auto start = fake_clock::now();
+    job_t j(1s, [] {});
+    j.fixed_rate(ticker::misfire::coalesce);
+    for (int i = 0; i < 3; i++) j.next_time_point(start);
+    auto due = first_due(j, start);
+    for (int i = 0; i < 3; i++) j.next_time_point(due + 1ms);
+    if (due != start + 1s || j.next_time_point(due + 1ms) != start + 2s || fire(j, due + 1ms) != start + 2s ||
+        j.next_time_point(start + 2s) != start + 3s) {
+      dbg_print("ERROR: expecting the queries leave the periods at +1s, +2s, +3s");
+      exit(-1);
+    }
+  }
+
+} // namespace
+
+int main() {
+  TICKER_TEST_FOR(test_every_job_drift);
+  TICKER_TEST_FOR(test_every_job_misfire);
+  TICKER_TEST_FOR(test_every_job_query);
+}
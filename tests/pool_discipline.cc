@@ -0,0 +1,191 @@
+// ticker_cxx Library
+// Copyright © 2021 Hedzr Yeh.
+//
+// This file is released under the terms of the MIT license.
+// Read /LICENSE for more information.
+
+//
+// Created by Hedzr Yeh on 2021/11/17.
+//
+
+// the queue disciplines of thread_pool: the order of the queued tasks,
+// and the waits of the tasks under a sustained overload
+
+#include "ticker_cxx/ticker-core.hh"
+#include "ticker_cxx/ticker-executor.hh"
+#include "ticker_cxx/ticker-log.hh"
+#include "ticker_cxx/ticker-pool.hh"
+#include "ticker_cxx/ticker-x-class.hh"
+#include "ticker_cxx/ticker-x-test.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+  ticker::debug::X x_global_var;
+
+  using namespace std::literals::chrono_literals;
+  using steady = std::chrono::steady_clock;
+
+  template<typename D>
+  struct discipline_name;
+  template<>
+  struct discipline_name<ticker::pool::discipline::fifo> { static constexpr const char *value = "fifo"; };
+  template<>
+  struct discipline_name<ticker::pool::discipline::lifo> { static constexpr const char *value = "lifo"; };
+  template<>
+  struct discipline_name<ticker::pool::discipline::edf> { static constexpr const char *value = "edf"; };
+
+  // the order the queued tasks run in, posted behind a blocked worker:
+  // task i is due at now + deadlines[i]
+  template<typename D>
+  std::vector<int> run_order(std::vector<int> const &deadlines) {
+    ticker::pool::basic_thread_pool<D> pool(1);
+    std::atomic<bool> started{false}, open{false};
+    pool.post([&] {
+      started = true;
+      while (!open) std::this_thread::yield();
+    });
+    while (!started) std::this_thread::yield();
+
+    std::mutex m;
+    std::vector<int> order;
+    ticker::pool::conditional_wait_for_int count{int(deadlines.size())};
+    auto now = steady::now();
+    for (int i = 0; i < int(deadlines.size()); i++)
+      pool.post([&, i] {
+        ticker::pool::cw_setter const cws(count);
+        std::lock_guard<std::mutex> l(m);
+        order.push_back(i);
+      },
+                now + std::chrono::milliseconds(deadlines[std::size_t(i)]));
+    open = true;
+    if (!count.wait_for(5s)) {
+      dbg_print("ERROR: %s: %d tasks left", discipline_name<D>::value, count.val());
+      exit(-1);
+    }
+    return order;
+  }
+
+  void test_discipline_order() {
+    const std::vector<int> deadlines{30, 10, 20, 10, 0, 40};
+    auto expect = [](const char *name, std::vector<int> const &got, std::vector<int> const &want) {
+      if (got != want) {
+        dbg_print("ERROR: %s: unexpected order of the queued tasks", name);
+        exit(-1);
+      }
+    };
+    expect("fifo", run_order<ticker::pool::discipline::fifo>(deadlines), {0, 1, 2, 3, 4, 5});
+    expect("lifo", run_order<ticker::pool::discipline::lifo>(deadlines), {5, 4, 3, 2, 1, 0});
+    expect("edf", run_order<ticker::pool::discipline::edf>(deadlines), {4, 1, 3, 2, 0, 5}); // the ties go FIFO
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+  // one worker, the tasks posted twice as fast as they run; returns the
+  // worst wait, each task is due when it's posted
+  template<typename D>
+  double overload() {
+    const int n = 400;
+    const auto service = 200us;
+    std::vector<double> waits(n);
+    ticker::pool::conditional_wait_for_int count{n};
+    {
+      ticker::pool::basic_thread_pool<D> pool(1);
+      auto next = steady::now();
+      for (int i = 0; i < n; i++) {
+        auto posted = steady::now();
+        pool.post([&waits, &count, i, posted, service] {
+          ticker::pool::cw_setter const cws(count);
+          auto start = steady::now();
+          waits[std::size_t(i)] = std::chrono::duration<double, std::milli>(start - posted).count();
+          while (steady::now() - start < service)
+            ;
+        },
+                  posted);
+        next += service / 2;
+        std::this_thread::sleep_until(next);
+      }
+      if (!count.wait_for(10s)) {
+        dbg_print("ERROR: %s: %d tasks left", discipline_name<D>::value, count.val());
+        exit(-1);
+      }
+    }
+    std::sort(waits.begin(), waits.end());
+    printf("  - %-4s waits: p50 %8.3f ms, p99 %8.3f ms, max %8.3f ms\n", discipline_name<D>::value,
+           waits[n / 2], waits[n * 99 / 100], waits.back());
+    return waits.back();
+  }
+
+  void test_overload_tail_latency() {
+    auto fifo = overload<ticker::pool::discipline::fifo>();
+    auto lifo = overload<ticker::pool::discipline::lifo>();
+    auto edf = overload<ticker::pool::discipline::edf>();
+    // the first tasks queued starve behind the newer ones with lifo
+    if (!(fifo < lifo) || !(edf < lifo)) {
+      dbg_print("ERROR: expecting the worst wait of fifo (%.3fms) and edf (%.3fms) below lifo (%.3fms)", fifo, edf, lifo);
+      exit(-1);
+    }
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+  // runs the tasks inline, and records their deadlines
+  struct deadline_recorder {
+    template<typename F>
+    void post(F &&f) { post(std::forward<F>(f), steady::time_point::min()); }
+    template<typename F>
+    void post(F &&f, ticker::pool::deadline_t d) {
+      deadlines.push_back(d);
+      std::forward<F>(f)();
+    }
+    std::vector<ticker::pool::deadline_t> deadlines{};
+  };
+
+  void test_job_deadline() {
+    static_assert(ticker::pool::is_deadline_executor_v<ticker::pool::any_executor>);
+    static_assert(ticker::pool::is_deadline_executor_v<ticker::pool::basic_thread_pool<ticker::pool::discipline::edf>>);
+    static_assert(!ticker::pool::is_deadline_executor_v<ticker::pool::inline_executor>);
+
+    auto rec = std::make_shared<deadline_recorder>();
+    auto t = ticker::timer_t<>::get(rec);
+    ticker::pool::conditional_wait_for_int count{1};
+    auto due = ticker::Clock::now() + 20ms;
+    auto steady_due = steady::now() + 20ms;
+    t->schedule(due, [&count] { ticker::pool::cw_setter const cws(count); });
+    if (!count.wait_for(2s) || rec->deadlines.size() != 1) {
+      dbg_print("ERROR: expecting the job run on the recorder");
+      exit(-1);
+    }
+    auto off = std::chrono::duration<double, std::milli>(rec->deadlines[0] - steady_due).count();
+    if (off < -5 || off > 5) {
+      dbg_print("ERROR: expecting the deadline of the task at the due time of the job, off by %.3fms", off);
+      exit(-1);
+    }
+
+    // the jobs on an edf pool
+    auto pool = std::make_shared<ticker::pool::basic_thread_pool<ticker::pool::discipline::edf>>(2);
+    auto e = ticker::timer_t<>::get(pool);
+    ticker::pool::conditional_wait_for_int jobs{50};
+    for (int i = 0; i < 50; i++)
+      e->after(std::chrono::milliseconds(i % 5)).on([&jobs] { ticker::pool::cw_setter const cws(jobs); }).build();
+    if (!jobs.wait_for(5s)) {
+      dbg_print("ERROR: expecting the jobs run on the edf pool, %d left", jobs.val());
+      exit(-1);
+    }
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+} // namespace
+
+int main() {
+  TICKER_TEST_FOR(test_discipline_order);
+  TICKER_TEST_FOR(test_overload_tail_latency);
+  TICKER_TEST_FOR(test_job_deadline);
+}
@@ -0,0 +1,132 @@
+// ticker_cxx Library
+// Copyright © 2021 Hedzr Yeh.
+//
+// This file is released under the terms of the MIT license.
+// Read /LICENSE for more information.
+
+//
+// Created by Hedzr Yeh on 2021/11/18.
+//
+
+// the elastic thread_pool: grows under a burst, shrinks when idle
+
+#include "ticker_cxx/ticker-core.hh"
+#include "ticker_cxx/ticker-log.hh"
+#include "ticker_cxx/ticker-pool.hh"
+#include "ticker_cxx/ticker-x-class.hh"
+#include "ticker_cxx/ticker-x-test.hh"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+
+namespace {
+
+  ticker::debug::X x_global_var;
+
+  using namespace std::literals::chrono_literals;
+
+  template<typename Pool, typename Pred>
+  bool eventually(Pool const &pool, std::chrono::milliseconds d, Pred &&pred) {
+    auto until = std::chrono::steady_clock::now() + d;
+    while (!pred(pool.total_threads())) {
+      if (std::chrono::steady_clock::now() > until) return false;
+      std::this_thread::sleep_for(1ms);
+    }
+    return true;
+  }
+
+  void test_elastic_grow_and_retire() {
+    ticker::pool::thread_pool pool(ticker::pool::elastic_options{1, 4, 200ms, 5ms});
+    if (!pool.elastic() || pool.total_threads() != 1) {
+      dbg_print("ERROR: expecting an elastic pool of 1 worker, got %zu", pool.total_threads());
+      exit(-1);
+    }
+
+    // a burst of slow tasks, as the jobs of a cron-style timer due together
+    ticker::pool::conditional_wait_for_int count{8};
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 8; i++)
+      pool.post([&count] {
+        ticker::pool::cw_setter const cws(count);
+        std::this_thread::sleep_for(50ms);
+      });
+    if (!eventually(pool, 1000ms, [](std::size_t n) { return n == 4; })) {
+      dbg_print("ERROR: expecting the pool grows to 4 workers, got %zu", pool.total_threads());
+      exit(-1);
+    }
+    count.wait();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    printf("  - 8 tasks of 50ms ran in %.1fms, on %zu workers\n", elapsed.count(), pool.total_threads());
+    if (elapsed > 300ms) { // 400ms on one worker
+      dbg_print("ERROR: expecting the burst ran in parallel, took %.1fms", elapsed.count());
+      exit(-1);
+    }
+
+    // idle: back to min_workers
+    if (!eventually(pool, 2000ms, [](std::size_t n) { return n == 1; })) {
+      dbg_print("ERROR: expecting the idle workers retire, %zu left", pool.total_threads());
+      exit(-1);
+    }
+
+    // and grows again
+    ticker::pool::conditional_wait_for_int again{4};
+    for (int i = 0; i < 4; i++)
+      pool.post([&again] {
+        ticker::pool::cw_setter const cws(again);
+        std::this_thread::sleep_for(50ms);
+      });
+    if (!eventually(pool, 1000ms, [](std::size_t n) { return n > 1; }) || !again.wait_for(2s)) {
+      dbg_print("ERROR: expecting the pool grows again, %zu workers", pool.total_threads());
+      exit(-1);
+    }
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+  // the tasks spaced out never wait, so the pool doesn't grow
+  void test_elastic_light_load() {
+    ticker::pool::thread_pool pool(ticker::pool::elastic_options{1, 4, 1s, 20ms});
+    ticker::pool::conditional_wait_for_int count{20};
+    for (int i = 0; i < 20; i++) {
+      pool.post([&count] { ticker::pool::cw_setter const cws(count); });
+      std::this_thread::sleep_for(5ms);
+    }
+    count.wait();
+    if (pool.total_threads() != 1) {
+      dbg_print("ERROR: expecting 1 worker under a light load, got %zu", pool.total_threads());
+      exit(-1);
+    }
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+  void test_elastic_timer() {
+    auto pool = std::make_shared<ticker::pool::thread_pool>(ticker::pool::elastic_options{1, 8, 100ms, 5ms});
+    auto t = ticker::timer_t<>::get(pool);
+    ticker::pool::conditional_wait_for_int count{16};
+    auto due = ticker::Clock::now() + 10ms;
+    for (int i = 0; i < 16; i++)
+      t->schedule(due, [&count] {
+        ticker::pool::cw_setter const cws(count);
+        std::this_thread::sleep_for(20ms);
+      });
+    if (!count.wait_for(5s)) {
+      dbg_print("ERROR: expecting the jobs run on the elastic pool, %d left", count.val());
+      exit(-1);
+    }
+    printf("  - %zu workers after the burst\n", pool->total_threads());
+    if (!eventually(*pool, 2000ms, [](std::size_t n) { return n == 1; })) {
+      dbg_print("ERROR: expecting the idle workers retire, %zu left", pool->total_threads());
+      exit(-1);
+    }
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+} // namespace
+
+int main() {
+  TICKER_TEST_FOR(test_elastic_grow_and_retire);
+  TICKER_TEST_FOR(test_elastic_light_load);
+  TICKER_TEST_FOR(test_elastic_timer);
+}
@@ -0,0 +1,204 @@
+// ticker_cxx Library
+// Copyright © 2021 Hedzr Yeh.
+//
+// This file is released under the terms of the MIT license.
+// Read /LICENSE for more information.
+
+//
+// Created by Hedzr Yeh on 2021/11/17.
+//
+
+// the bounded lock-free ring, and the thread pool on it
+
+#include "ticker_cxx/ticker-log.hh"
+#include "ticker_cxx/ticker-pool.hh"
+#include "ticker_cxx/ticker-ringbuf.hh"
+#include "ticker_cxx/ticker-x-class.hh"
+#include "ticker_cxx/ticker-x-test.hh"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <thread>
+#include <vector>
+
+namespace {
+  // of this thread only, the workers of a pool allocate for themselves
+  thread_local std::size_t allocations{0};
+} // namespace
+
+void *operator new(std::size_t n) {
+  allocations++;
+  if (void *p = std::malloc(n ? n : 1)) return p;
+  throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+  ticker::debug::X x_global_var;
+
+  using namespace std::literals::chrono_literals;
+
+  void test_ring_buffer() {
+    ticker::pool::ring_buffer<std::unique_ptr<int>> r(5);
+    if (r.capacity() != 8 || !r.empty() || r.try_pop()) {
+      dbg_print("ERROR: expecting an empty ring of 8 slots, got %zu", r.capacity());
+      exit(-1);
+    }
+    for (int i = 0; i < 8; i++) {
+      if (!r.try_push(std::make_unique<int>(i))) {
+        dbg_print("ERROR: expecting the push of item %d succeeds", i);
+        exit(-1);
+      }
+    }
+    auto extra = std::make_unique<int>(8);
+    if (r.try_push(std::move(extra)) || !extra || r.size() != 8) {
+      dbg_print("ERROR: expecting the push to a full ring fails and leaves the item");
+      exit(-1);
+    }
+    for (int round = 0; round < 3; round++) { // wraps around
+      for (int i = 0; i < 8; i++) {
+        auto v = r.try_pop();
+        if (!v || **v != i) {
+          dbg_print("ERROR: expecting item %d in FIFO order, round %d", i, round);
+          exit(-1);
+        }
+        r.try_push(std::make_unique<int>(i));
+      }
+    }
+    printf("end of %s\n", __FUNCTION_NAME__);
+  } // the ring releases the items left
+
+  // every item of each producer is popped once, in the order pushed
+  void test_ring_mpmc() {
+    const int producers = 4, consumers = 4, n = 50000;
+    ticker::pool::ring_buffer<std::uint64_t> r(64);
+    std::vector<std::atomic<int>> seen(std::size_t(producers * n));
+    std::atomic<int> popped{0}, disorders{0};
+    std::vector<std::thread> threads;
+    for (int c = 0; c < consumers; c++)
+      threads.emplace_back([&] {
+        std::vector<int> last(producers, -1);
+        while (popped.load() < producers * n) {
+          if (auto v = r.try_pop()) {
+            int p = int(*v >> 32), i = int(*v & 0xffffffff);
+            if (i <= last[std::size_t(p)]) disorders++;
+            last[std::size_t(p)] = i;
+            seen[std::size_t(p * n + i)]++;
+            popped++;
+          } else {
+            std::this_thread::yield();
+          }
+        }
+      });
+    for (int p = 0; p < producers; p++)
+      threads.emplace_back([&r, p] {
+        for (int i = 0; i < n; i++)
+          while (!r.try_push((std::uint64_t(p) << 32) | std::uint64_t(i)))
+            std::this_thread::yield();
+      });
+    for (auto &t : threads) t.join();
+    for (auto &s : seen) {
+      if (s.load() != 1) {
+        dbg_print("ERROR: expecting each item popped once, got %d", s.load());
+        exit(-1);
+      }
+    }
+    if (disorders.load() != 0 || !r.empty()) {
+      dbg_print("ERROR: expecting the items of a producer in order, %d out of order", disorders.load());
+      exit(-1);
+    }
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+  // the allocations of posting 512 tasks behind a blocked worker
+  template<typename Pool>
+  std::size_t post_backlog(const char *name) {
+    const int n = 512;
+    Pool pool(1);
+    std::atomic<bool> started{false}, open{false};
+    pool.post([&] {
+      started = true;
+      while (!open) std::this_thread::yield();
+    });
+    while (!started) std::this_thread::yield();
+
+    ticker::pool::conditional_wait_for_int count{n};
+    std::size_t got{};
+    auto before = allocations;
+    for (int i = 0; i < n; i++)
+      pool.post([&count] { ticker::pool::cw_setter const cws(count); });
+    got = allocations - before;
+    open = true;
+    if (!count.wait_for(5s)) {
+      dbg_print("ERROR: %s: %d tasks left", name, count.val());
+      exit(-1);
+    }
+    printf("  - %-40s %zu allocations\n", name, got);
+    return got;
+  }
+
+  void test_ring_pool_post() {
+    using ring_pool = ticker::pool::basic_thread_pool<ticker::pool::discipline::ring<1024>>;
+    static_assert(ticker::pool::threaded_message_queue<ticker::pool::pool_task, ticker::pool::discipline::ring<>>::lock_free);
+    static_assert(!ticker::pool::threaded_message_queue<ticker::pool::pool_task>::lock_free);
+    post_backlog<ticker::pool::thread_pool>("512 tasks queued, thread_pool");
+    if (post_backlog<ring_pool>("512 tasks queued, discipline::ring<>") != 0) {
+      dbg_print("ERROR: expecting the posts to the ring allocate nothing");
+      exit(-1);
+    }
+
+    // a ring smaller than the backlog: the producer waits for the slots
+    ticker::pool::basic_thread_pool<ticker::pool::discipline::ring<16>> small(2);
+    ticker::pool::conditional_wait_for_int count{1000};
+    for (int i = 0; i < 1000; i++)
+      small.post([&count] { ticker::pool::cw_setter const cws(count); });
+    if (!count.wait_for(5s)) {
+      dbg_print("ERROR: expecting the tasks run on a small ring, %d left", count.val());
+      exit(-1);
+    }
+    auto f = small.queue_task([] { return 42; });
+    if (f.get() != 42) {
+      dbg_print("ERROR: expecting queue_task() returns the result");
+      exit(-1);
+    }
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+  // 4 threads post to 4 workers
+  template<typename Pool>
+  void bench_post(const char *name) {
+    const int producers = 4, n = 25000;
+    Pool pool(4);
+    ticker::pool::conditional_wait_for_int count{producers * n};
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++)
+      threads.emplace_back([&] {
+        for (int i = 0; i < n; i++)
+          pool.post([&count] { ticker::pool::cw_setter const cws(count); });
+      });
+    for (auto &t : threads) t.join();
+    count.wait();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    printf("  - %-40s %10.0f tasks/s\n", name, producers * n / elapsed.count());
+  }
+
+  void bench_ring_pool() {
+    bench_post<ticker::pool::thread_pool>("thread_pool");
+    bench_post<ticker::pool::basic_thread_pool<ticker::pool::discipline::ring<>>>("basic_thread_pool<discipline::ring<>>");
+  }
+
+} // namespace
+
+int main() {
+  TICKER_TEST_FOR(test_ring_buffer);
+  TICKER_TEST_FOR(test_ring_mpmc);
+  TICKER_TEST_FOR(test_ring_pool_post);
+  TICKER_TEST_FOR(bench_ring_pool);
+}
@@ -0,0 +1,152 @@
+// ticker_cxx Library
+// Copyright © 2021 Hedzr Yeh.
+//
+// This file is released under the terms of the MIT license.
+// Read /LICENSE for more information.
+
+//
+// Created by Hedzr Yeh on 2021/11/14.
+//
+
+// the slab arena recycles the jobs and the queue buckets
+
+#include "ticker_cxx/ticker-core.hh"
+#include "ticker_cxx/ticker-executor.hh"
+#include "ticker_cxx/ticker-log.hh"
+#include "ticker_cxx/ticker-slab.hh"
+#include "ticker_cxx/ticker-timer-queue.hh"
+#include "ticker_cxx/ticker-x-class.hh"
+#include "ticker_cxx/ticker-x-test.hh"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <thread>
+#include <vector>
+
+namespace {
+  // of this thread only
+  thread_local std::size_t allocations{0};
+} // namespace
+
+void *operator new(std::size_t n) {
+  allocations++;
+  if (void *p = std::malloc(n ? n : 1)) return p;
+  throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+  ticker::debug::X x_global_var;
+
+  void test_slab_arena() {
+    ticker::pool::slab_arena a;
+    void *p = a.allocate(40);
+    a.deallocate(p, 40);
+    void *q = a.allocate(48); // the same size class
+    if (q != p) {
+      dbg_print("ERROR: expecting a freed block is reused at once");
+      exit(-1);
+    }
+    a.deallocate(q, 48);
+
+    std::vector<void *> blocks;
+    for (int i = 0; i < 1000; i++) blocks.push_back(a.allocate(100));
+    for (auto *b : blocks) a.deallocate(b, 100);
+    auto chunks = a.stats().chunks;
+    blocks.clear();
+    for (int i = 0; i < 1000; i++) blocks.push_back(a.allocate(100));
+    for (auto *b : blocks) a.deallocate(b, 100);
+
+    void *big = a.allocate(4096);
+    a.deallocate(big, 4096);
+
+    auto st = a.stats();
+    printf("  - allocations: %zu, hits: %zu, fallbacks: %zu, chunks: %zu, reserved: %zu bytes, in use: %zu\n",
+           st.allocations, st.hits, st.fallbacks, st.chunks, st.reserved, st.in_use);
+    if (st.chunks != chunks || st.fallbacks != 1 || st.in_use != 0 || st.allocations != st.deallocations) {
+      dbg_print("ERROR: expecting the second round reuses the chunks of the first one");
+      exit(-1);
+    }
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+  void test_map_queue_churn() {
+    using clock = std::chrono::steady_clock;
+    using queue_t = ticker::queue::map_queue<clock, std::shared_ptr<int>>;
+    const int n = 1000;
+    auto arena = std::make_shared<ticker::pool::slab_arena>();
+    queue_t q(arena);
+    auto job = std::make_shared<int>(1);
+    auto start = clock::now();
+    queue_t::jobs_t out;
+    out.reserve(n);
+
+    // each job at its own time point makes a bucket of its own
+    auto round = [&] {
+      for (int i = 0; i < n; i++) q.add(start + std::chrono::microseconds(i), std::shared_ptr<int>(job));
+      q.pop_expired(start + std::chrono::seconds(1), out);
+      if (out.size() != std::size_t(n) || !q.empty()) {
+        dbg_print("ERROR: expecting %d jobs popped, got %zu", n, out.size());
+        exit(-1);
+      }
+      out.clear();
+    };
+    round(); // warms the arena up
+    auto before = allocations;
+    round();
+    auto got = allocations - before;
+    printf("  - %-48s %zu allocations\n", "1000 buckets added and popped", got);
+    if (got != 0) {
+      dbg_print("ERROR: expecting the buckets come from the arena, but got %zu allocations", got);
+      exit(-1);
+    }
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+  void test_timer_churn() {
+    using namespace std::literals::chrono_literals;
+    const int n = 500;
+    auto t = ticker::timer_t<>::get(std::make_shared<ticker::pool::inline_executor>());
+    auto round = [&] {
+      ticker::pool::conditional_wait_for_int count{n};
+      auto now = ticker::Clock::now(); // all of them are pending together
+      for (int i = 0; i < n; i++)
+        t->schedule(now + 200ms + std::chrono::microseconds(i), [&count] { ticker::pool::cw_setter const cws(count); });
+      count.wait();
+    };
+    // all jobs released, after the runner dropped its references
+    auto drained = [&] {
+      for (int i = 0; i < 100 && t->allocator_stats().in_use != 0; i++)
+        std::this_thread::sleep_for(1ms);
+      return t->allocator_stats();
+    };
+
+    round();
+    auto first = drained();
+    round();
+    auto second = drained();
+    printf("  - round 1: allocations: %zu, chunks: %zu, in use: %zu\n", first.allocations, first.chunks, first.in_use);
+    printf("  - round 2: allocations: %zu, chunks: %zu, in use: %zu\n", second.allocations, second.chunks, second.in_use);
+    if (second.in_use != 0) {
+      dbg_print("ERROR: expecting the fired jobs given back, %zu blocks in use", second.in_use);
+      exit(-1);
+    }
+    if (second.chunks != first.chunks || second.allocations < 2 * first.allocations) {
+      dbg_print("ERROR: expecting round 2 reuses the blocks of round 1 (chunks %zu -> %zu)", first.chunks, second.chunks);
+      exit(-1);
+    }
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+} // namespace
+
+int main() {
+  TICKER_TEST_FOR(test_slab_arena);
+  TICKER_TEST_FOR(test_map_queue_churn);
+  TICKER_TEST_FOR(test_timer_churn);
+}
@@ -0,0 +1,161 @@
+// ticker_cxx Library
+// Copyright © 2021 Hedzr Yeh.
+//
+// This file is released under the terms of the MIT license.
+// Read /LICENSE for more information.
+
+//
+// Created by Hedzr Yeh on 2021/11/13.
+//
+
+// counts the heap allocations of the callables, and of firing a job
+
+#include "ticker_cxx/ticker-executor.hh"
+#include "ticker_cxx/ticker-jobs.hh"
+#include "ticker_cxx/ticker-log.hh"
+#include "ticker_cxx/ticker-pool.hh"
+#include "ticker_cxx/ticker-small-function.hh"
+#include "ticker_cxx/ticker-x-class.hh"
+#include "ticker_cxx/ticker-x-test.hh"
+
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+namespace {
+  // of this thread only, the workers of a pool allocate for themselves
+  thread_local std::size_t allocations{0};
+} // namespace
+
+void *operator new(std::size_t n) {
+  allocations++;
+  if (void *p = std::malloc(n ? n : 1)) return p;
+  throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+  ticker::debug::X x_global_var;
+
+  // the allocations made by f
+  template<typename F>
+  std::size_t count_allocations(F &&f) {
+    auto before = allocations;
+    f();
+    return allocations - before;
+  }
+
+  void expect(const char *what, std::size_t got, std::size_t expected) {
+    printf("  - %-48s %zu allocations\n", what, got);
+    if (got != expected) {
+      dbg_print("ERROR: %s: expecting %zu allocations but got %zu", what, expected, got);
+      exit(-1);
+    }
+  }
+
+  void test_small_function() {
+    int hits{0};
+    std::array<char, 32> pad{};
+    expect("a 40-byte capture: make, move, call", count_allocations([&] {
+             ticker::pool::task_fn f([&hits, pad] { hits += pad[0] + 1; });
+             ticker::pool::task_fn g(std::move(f));
+             g();
+             if (f || !g.is_inline()) exit(-1);
+           }),
+           0);
+
+    std::array<char, 128> big{};
+    expect("a 136-byte capture: make, move, call", count_allocations([&] {
+             ticker::pool::task_fn f([&hits, big] { hits += big[0] + 1; });
+             ticker::pool::task_fn g(std::move(f));
+             g();
+             if (g.is_inline()) exit(-1);
+           }),
+           1);
+
+    auto task = std::make_unique<int>(1); // a move-only capture
+    expect("a move-only capture", count_allocations([&] {
+             ticker::pool::task_fn f([&hits, p = std::move(task)] { hits += *p; });
+             f();
+           }),
+           0);
+
+    if (hits != 3) {
+      dbg_print("ERROR: expecting 3 hits but got %d", hits);
+      exit(-1);
+    }
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+  void test_job_launch() {
+    const int n = 1000;
+    int hits{0};
+    std::array<char, 24> pad{};
+    auto j = std::make_shared<ticker::detail::in_job<>>([&hits, pad] { hits += pad[0] + 1; });
+    auto ex = std::make_shared<ticker::pool::inline_executor>();
+    ticker::pool::any_executor any(ex);
+
+    // the debug builds log every 10th launch, those are not counted
+    std::size_t fired{};
+    for (int i = 0; i < n; i++) {
+      if (j->hits() % 10 == 0)
+        j->launch_to(*ex);
+      else
+        fired += count_allocations([&] { j->launch_to(*ex); });
+    }
+    expect("1000 jobs fired on an inline_executor", fired, 0);
+    fired = 0;
+    for (int i = 0; i < n; i++) {
+      if (j->hits() % 10 == 0)
+        j->launch_to(any, [&hits](auto *) { hits++; });
+      else
+        fired += count_allocations([&] { j->launch_to(any, [&hits](auto *) { hits++; }); });
+    }
+    expect("1000 jobs fired through any_executor", fired, 0);
+    if (hits != 3 * n) {
+      dbg_print("ERROR: expecting %d hits but got %d", 3 * n, hits);
+      exit(-1);
+    }
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+  void test_thread_pool_post() {
+    const int n = 100;
+    ticker::pool::thread_pool pool(1);
+    std::array<char, 24> pad{};
+    ticker::pool::conditional_wait_for_int done{1};
+    pool.post([&done] { ticker::pool::cw_setter const cws(done); }); // warms the queue up
+    done.wait();
+
+    std::size_t posted{}, queued{};
+    for (int i = 0; i < n; i++) {
+      ticker::pool::conditional_wait_for_int count{1};
+      posted += count_allocations([&] { pool.post([&count, pad] { ticker::pool::cw_setter const cws(count); }); });
+      count.wait();
+    }
+    expect("100 tasks posted", posted, 0);
+    for (int i = 0; i < n; i++) {
+      ticker::pool::conditional_wait_for_int count{1};
+      queued += count_allocations([&] { pool.queue_task([&count, pad] { ticker::pool::cw_setter const cws(count); }); });
+      count.wait();
+    }
+    printf("  - %-48s %zu allocations\n", "100 tasks queued with futures", queued);
+    if (queued < std::size_t(n)) {
+      dbg_print("ERROR: expecting queue_task() allocates the shared states");
+      exit(-1);
+    }
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+} // namespace
+
+int main() {
+  TICKER_TEST_FOR(test_small_function);
+  TICKER_TEST_FOR(test_job_launch);
+  TICKER_TEST_FOR(test_thread_pool_post);
+}
@@ -0,0 +1,240 @@
+// ticker_cxx Library
+// Copyright © 2021 Hedzr Yeh.
+//
+// This file is released under the terms of the MIT license.
+// Read /LICENSE for more information.
+
+//
+// Created by Hedzr Yeh on 2021/11/02.
+//
+
+#include "ticker_cxx/ticker-log.hh"
+#include "ticker_cxx/ticker-timer-queue.hh"
+#include "ticker_cxx/ticker-x-class.hh"
+#include "ticker_cxx/ticker-x-test.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+  ticker::debug::X x_global_var;
+
+  // a manual clock, so the queues can be driven deterministically
+  struct fake_clock {
+    using duration = std::chrono::nanoseconds;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<fake_clock>;
+    static constexpr bool is_steady = true;
+    static time_point now() noexcept { return _now; }
+    static inline time_point _now{std::chrono::hours(24 * 365 * 50)};
+  };
+
+  // a job of the intrusive queues
+  struct node {
+    explicit node(int i)
+        : id(i) {}
+    int id;
+    ticker::queue::intrusive_hook<node> hook{};
+    ticker::queue::intrusive_hook<node> *queue_hook() { return &hook; }
+  };
+  using node_ptr = std::shared_ptr<node>;
+
+  int id_of(int i) { return i; }
+  int id_of(node_ptr const &n) { return n->id; }
+
+  template<typename Queue>
+  void check_queue(const char *name, std::chrono::nanoseconds tick) {
+    using job_t = typename Queue::job_type;
+    using namespace std::literals::chrono_literals;
+    using tp_t = fake_clock::time_point;
+
+    std::mt19937_64 rng(20211102);
+    std::uniform_int_distribution<std::int64_t> deadline_dist(0, std::chrono::nanoseconds(90s).count());
+    std::uniform_int_distribution<std::int64_t> step_dist(0, std::chrono::nanoseconds(300ms).count());
+
+    Queue q;
+    const auto start = fake_clock::now();
+    const int count = 20000;
+    std::vector<tp_t> deadlines;
+    std::vector<job_t> jobs;
+    for (int i = 0; i < count; i++) {
+      deadlines.push_back(start + std::chrono::nanoseconds(deadline_dist(rng)));
+      if constexpr (std::is_same_v<job_t, int>)
+        jobs.push_back(i);
+      else
+        jobs.push_back(std::make_shared<node>(i));
+    }
+    // the first half one by one, the rest in a sorted batch
+    typename Queue::items_t items;
+    for (int i = 0; i < count; i++) {
+      if (i < count / 2)
+        q.add(deadlines[i], job_t(jobs[i]));
+      else
+        items.emplace_back(deadlines[i], jobs[i]);
+    }
+    std::stable_sort(items.begin(), items.end(), [](auto const &a, auto const &b) { return a.first < b.first; });
+    q.add_sorted(std::move(items));
+    // a few far-away ones are removed before they expire
+    int removed = 0;
+    for (int i = 0; i < count; i += 97, removed++)
+      q.remove(deadlines[i], jobs[i]);
+    if (q.size() != std::size_t(count - removed)) {
+      dbg_print("%s: ERROR: expecting %d jobs but got %zu", name, count - removed, q.size());
+      exit(-1);
+    }
+
+    std::vector<bool> fired(count);
+    tp_t prev = start, now = start;
+    int total = 0;
+    while (!q.empty()) {
+      now += std::chrono::nanoseconds(step_dist(rng));
+      fake_clock::_now = now;
+
+      tp_t next;
+      if (!q.next_time_point(next) || next > now + 100s) {
+        dbg_print("%s: ERROR: next_time_point() is wrong", name);
+        exit(-1);
+      }
+
+      typename Queue::jobs_t out;
+      q.pop_expired(now, out);
+      for (auto const &j : out) {
+        auto i = id_of(j);
+        if (i % 97 == 0 || fired[i]) {
+          dbg_print("%s: ERROR: job %d fired unexpectedly", name, i);
+          exit(-1);
+        }
+        // never early, and no later than one tick after the previous scan
+        if (deadlines[i] > now || deadlines[i] + tick <= prev) {
+          dbg_print("%s: ERROR: job %d fired at wrong time", name, i);
+          exit(-1);
+        }
+        fired[i] = true, total++;
+      }
+      prev = now;
+    }
+    if (total != count - removed) {
+      dbg_print("%s: ERROR: expecting %d fired jobs but got %d", name, count - removed, total);
+      exit(-1);
+    }
+    dbg_print("%40s: %d jobs fired, %d removed", name, total, removed);
+  }
+
+  void test_map_queue() {
+    using namespace std::literals::chrono_literals;
+    check_queue<ticker::queue::map_queue<fake_clock, int>>("map_queue", 0ns);
+  }
+
+  void test_timing_wheel() {
+    using namespace std::literals::chrono_literals;
+    check_queue<ticker::queue::timing_wheel<fake_clock, int>>("timing_wheel<1ms, 8, 4>", 1ms);
+    // small levels, so the cascading and the overflow bucket get exercised
+    check_queue<ticker::queue::timing_wheel<fake_clock, int, std::chrono::microseconds, 6, 3>>("timing_wheel<1us, 6, 3>", 1us);
+    check_queue<ticker::queue::timing_wheel<fake_clock, int, std::chrono::milliseconds, 3, 3>>("timing_wheel<1ms, 3, 3>", 1ms);
+  }
+
+  // removes the jobs placed from an earlier tick, after the wheel
+  // moved past the level boundaries and wrapped its top level
+  template<typename Queue>
+  void check_remove_after_advance(const char *name) {
+    using namespace std::literals::chrono_literals;
+    using job_t = typename Queue::job_type;
+    auto make = [](int i) {
+      if constexpr (std::is_same_v<job_t, int>)
+        return i;
+      else
+        return std::make_shared<node>(i);
+    };
+    auto saved = fake_clock::_now;
+    // aligned to the top level of 3 levels of 8 slots, 512 ticks
+    auto start = fake_clock::time_point(std::chrono::floor<std::chrono::milliseconds>(saved.time_since_epoch()) / 512 * 512);
+    fake_clock::_now = start;
+    Queue q;
+    std::vector<job_t> jobs{make(0), make(1), make(2), make(3), make(4)};
+    const std::vector<std::chrono::milliseconds> due{20ms, 300ms, 2000ms, 450ms, 3000ms};
+    for (std::size_t i = 0; i < jobs.size(); i++) q.add(start + due[i], job_t(jobs[i]));
+
+    typename Queue::jobs_t out;
+    q.pop_expired(start + 130ms, out); // past the level 1 boundaries at 64 and 128
+    q.remove(start + due[1], jobs[1]); // placed at level 2
+    q.remove(start + due[2], jobs[2]); // in the overflow
+    if (out.size() != 1 || q.size() != 2) {
+      dbg_print("%s: ERROR: expecting 2 jobs left but got %zu", name, q.size());
+      exit(-1);
+    }
+    q.pop_expired(start + 600ms, out); // past the top level wrap
+    q.remove(start + due[4], jobs[4]); // rehashed into the overflow
+    if (out.size() != 2 || id_of(out[1]) != 3 || !q.empty()) {
+      dbg_print("%s: ERROR: expecting the removed jobs gone, %zu left", name, q.size());
+      exit(-1);
+    }
+    q.pop_expired(start + 5000ms, out);
+    if (out.size() != 2) {
+      dbg_print("%s: ERROR: expecting no removed job fires", name);
+      exit(-1);
+    }
+    fake_clock::_now = saved;
+  }
+
+  void test_wheel_remove() {
+    using namespace std::literals::chrono_literals;
+    check_remove_after_advance<ticker::queue::timing_wheel<fake_clock, int, std::chrono::milliseconds, 3, 3>>("timing_wheel<1ms, 3, 3>");
+    check_remove_after_advance<ticker::queue::intrusive_wheel_policy<std::chrono::milliseconds, 3, 3>::queue_t<fake_clock, node_ptr>>("intrusive timing_wheel<1ms, 3, 3>");
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+  void test_intrusive_wheel() {
+    using namespace std::literals::chrono_literals;
+    using wheel_t = ticker::queue::intrusive_wheel_policy<>::queue_t<fake_clock, node_ptr>;
+    check_queue<wheel_t>("intrusive timing_wheel<1ms, 8, 4>", 1ms);
+    check_queue<ticker::queue::intrusive_wheel_policy<std::chrono::milliseconds, 3, 3>::queue_t<fake_clock, node_ptr>>("intrusive timing_wheel<1ms, 3, 3>", 1ms);
+
+    // linked and unlinked without touching the reference count
+    wheel_t q;
+    auto j = std::make_shared<node>(1);
+    q.add(fake_clock::now() + 5ms, node_ptr(j));
+    if (j.use_count() != 2 || j->hook.list == nullptr) {
+      dbg_print("ERROR: expecting the wheel holds the job by its hook");
+      exit(-1);
+    }
+    q.remove(fake_clock::now(), j); // a wrong time point, its bucket doesn't hold it
+    if (q.size() != 1) {
+      dbg_print("ERROR: expecting a stray remove() is ignored");
+      exit(-1);
+    }
+    q.remove(fake_clock::now() + 5ms, j);
+    if (!q.empty() || j.use_count() != 1 || j->hook.list != nullptr) {
+      dbg_print("ERROR: expecting the job is unlinked and released by the wheel");
+      exit(-1);
+    }
+    q.add(fake_clock::now() + 5ms, node_ptr(j));
+    q.clear();
+    if (j.use_count() != 1) {
+      dbg_print("ERROR: expecting clear() releases the linked jobs");
+      exit(-1);
+    }
+  }
+
+  void test_dary_heap() {
+    using namespace std::literals::chrono_literals;
+    check_queue<ticker::queue::dary_heap_queue<fake_clock, int>>("dary_heap_queue<4>", 0ns);
+    check_queue<ticker::queue::dary_heap_queue<fake_clock, int, 2>>("dary_heap_queue<2>", 0ns);
+    check_queue<ticker::queue::dary_heap_queue<fake_clock, int, 8>>("dary_heap_queue<8>", 0ns);
+  }
+
+} // namespace
+
+int main() {
+  TICKER_TEST_FOR(test_map_queue);
+  TICKER_TEST_FOR(test_timing_wheel);
+  TICKER_TEST_FOR(test_intrusive_wheel);
+  TICKER_TEST_FOR(test_wheel_remove);
+  TICKER_TEST_FOR(test_dary_heap);
+}
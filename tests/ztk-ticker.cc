@@ -12,6 +12,9 @@
 
 // #define TICKER_CXX_ENABLE_THREAD_POOL_READY_SIGNAL 1
 
+// a stopping scheduler waits 200ms for its running interval jobs
+#define TICKER_CXX_STOP_TIMEOUT_MS 200
+
 #include "ticker_cxx/ticker-chrono.hh"
 #include "ticker_cxx/ticker-core.hh"
 #include "ticker_cxx/ticker-def.hh"
@@ -20,8 +23,14 @@
 #include "ticker_cxx/ticker-x-class.hh"
 #include "ticker_cxx/ticker-x-test.hh"
 
+#include <atomic>
 #include <chrono>
 #include <cstdio>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
 namespace {
 
@@ -65,6 +74,186 @@ namespace {
         .build();
 
     count2.wait();
+
+    // the next run is due a period after the last one completed, not
+    // after it started; interval() drops the fixed_rate() set before it
+    std::mutex m;
+    std::vector<ticker::Clock::time_point> starts;
+    ticker::pool::conditional_wait_for_int count3{4};
+    t->fixed_rate()
+        .interval(20ms)
+        .on([&] {
+          {
+            std::unique_lock<std::mutex> l(m);
+            starts.push_back(ticker::Clock::now());
+          }
+          std::this_thread::sleep_for(30ms);
+          ticker::pool::cw_setter const cws(count3);
+        })
+        .build();
+    count3.wait();
+    t->clear();
+    std::unique_lock<std::mutex> l(m);
+    for (std::size_t i = 1; i < 4; i++) {
+      auto period = std::chrono::duration_cast<std::chrono::milliseconds>(starts[i] - starts[i - 1]);
+      printf("  - interval period %zu: %lldms\n", i, (long long) period.count());
+      if (period < 50ms) {
+        dbg_print("ERROR: expecting an interval period of 30ms run + 20ms, got %lldms", (long long) period.count());
+        exit(-1);
+      }
+    }
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+  // the copies of the front-ends share the scheduler, not a runner of their own
+  void test_ticker_copy() {
+    auto t = ticker::ticker_t<>::get();
+    ticker::ticker_t<> tc(*t);
+    auto a = ticker::alarm_t<>::get();
+    ticker::alarm_t<> ac(*a);
+    if (tc.get_scheduler() != t->get_scheduler() || ac.get_scheduler() != a->get_scheduler()) {
+      dbg_print("ERROR: expecting a copy of a ticker or an alarm sharing its scheduler");
+      exit(-1);
+    }
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+  void test_ticker_on_heap() {
+    using namespace std::literals::chrono_literals;
+    ticker::debug::X const x_local_var;
+
+    using heap_ticker = ticker::ticker_t<std::nullopt_t, ticker::Clock, false,
+                                         ticker::detail::every_job<ticker::Clock, false>,
+                                         ticker::queue::heap_policy<>>;
+    ticker::pool::conditional_wait_for_int count{8};
+    auto t = heap_ticker::get();
+    t->every(10ms)
+        .on([&count]() {
+          ticker::pool::cw_setter const cws(count);
+          printf("  - every [%02d]: %s\n", count.val(), ticker::chrono::format_time_point().c_str());
+        })
+        .build();
+
+    count.wait();
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+  void test_ticker_cancel() {
+    using namespace std::literals::chrono_literals;
+    ticker::debug::X const x_local_var;
+
+    ticker::pool::conditional_wait_for_int count{3};
+    std::atomic<int> hits{0};
+    auto t = ticker::ticker_t<>::get();
+    auto h = t->every(5ms)
+                     .on([&count, &hits]() {
+                       if (++hits <= 3) {
+                         ticker::pool::cw_setter const cws(count);
+                       }
+                     })
+                     .build();
+
+    count.wait();
+    if (!h.cancel()) {
+      dbg_print("ERROR: a running ticker should be cancellable");
+      exit(-1);
+    }
+    std::this_thread::sleep_for(20ms); // a launched one may still be running
+    int stopped = hits.load();
+    std::this_thread::sleep_for(50ms);
+    printf("  - %d hits after cancelled, %d later\n", stopped, hits.load());
+    if (hits.load() != stopped || h.pending()) {
+      dbg_print("ERROR: the ticker should be stopped by its handle");
+      exit(-1);
+    }
+
+    // the callable moved into the job: a second build() needs its own on()
+    bool rejected = false;
+    try {
+      t->build();
+    } catch (std::logic_error const &) {
+      rejected = true;
+    }
+    if (!rejected || t->pending_handles() != 0) {
+      dbg_print("ERROR: expecting a build() without on() rejected");
+      exit(-1);
+    }
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+  // an interval job outliving the wait of stop() doesn't recur, nor
+  // touch the scheduler gone
+  void test_ticker_stop_bounded() {
+    using namespace std::literals::chrono_literals;
+    ticker::debug::X const x_local_var;
+
+    auto pool = std::make_shared<ticker::pool::thread_pool>(2);
+    auto hits = std::make_shared<std::atomic<int>>(0);
+    ticker::pool::conditional_wait_for_bool running{};
+    auto s = std::make_shared<ticker::scheduler<>>(pool);
+    // an interval job is added back by its post-job, when it ends
+    auto job = [hits, &running] {
+      if (++*hits == 1) {
+        running.set();
+        std::this_thread::sleep_for(600ms);
+      }
+    };
+    s->add(ticker::Clock::now(), std::make_shared<ticker::detail::every_job<>>(1ms, job, true));
+    running.wait();
+    auto start = std::chrono::steady_clock::now();
+    s.reset(); // stops the scheduler
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    printf("  - stopped in %.1fms with an interval job running\n", elapsed.count());
+    if (elapsed > 500ms) {
+      dbg_print("ERROR: expecting stop() gives up after 200ms, took %.1fms", elapsed.count());
+      exit(-1);
+    }
+    std::this_thread::sleep_for(700ms); // the job ends, and finds the scheduler closed
+    if (hits->load() != 1) {
+      dbg_print("ERROR: expecting the interval job doesn't recur after stop(), %d hits", hits->load());
+      exit(-1);
+    }
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+  void test_ticker_wait_strategies() {
+    using namespace std::literals::chrono_literals;
+    ticker::debug::X const x_local_var;
+
+    for (auto strategy : {ticker::pool::wait_strategy::spin_then_park, ticker::pool::wait_strategy::busy_poll}) {
+      ticker::pool::conditional_wait_for_int count{8};
+      auto t = ticker::ticker_t<>::get();
+      t->wait_strategy(strategy, 200us);
+      auto h = t->every(1ms)
+                       .on([&count]() {
+                         if (count.val() < count.max_val()) {
+                           ticker::pool::cw_setter const cws(count);
+                         }
+                       })
+                       .build();
+      count.wait();
+      h.cancel();
+      printf("  - wait strategy %d: %d ticks\n", int(strategy), count.val());
+    }
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+  void test_steady_ticker() {
+    using namespace std::literals::chrono_literals;
+    ticker::debug::X const x_local_var;
+
+    ticker::pool::conditional_wait_for_int count{5};
+    auto t = ticker::steady_ticker::get();
+    auto h = t->every(2ms)
+                     .on([&count]() {
+                       if (count.val() < count.max_val()) {
+                         ticker::pool::cw_setter const cws(count);
+                       }
+                     })
+                     .build();
+    count.wait();
+    h.cancel();
+    printf("  - %d ticks on steady_clock\n", count.val());
     printf("end of %s\n", __FUNCTION_NAME__);
   }
 
@@ -74,6 +263,12 @@ int main() {
 
   TICKER_TEST_FOR(test_ticker);
   TICKER_TEST_FOR(test_ticker_interval);
+  TICKER_TEST_FOR(test_ticker_copy);
+  TICKER_TEST_FOR(test_ticker_on_heap);
+  TICKER_TEST_FOR(test_ticker_cancel);
+  TICKER_TEST_FOR(test_ticker_stop_bounded);
+  TICKER_TEST_FOR(test_ticker_wait_strategies);
+  TICKER_TEST_FOR(test_steady_ticker);
 
   // TICKER_TEST_FOR(test_alarm);
 
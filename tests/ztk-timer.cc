@@ -20,13 +20,35 @@
 #include "ticker_cxx/ticker-x-class.hh"
 #include "ticker_cxx/ticker-x-test.hh"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// the tolerated lateness of a fired timer, override it with
+// -DTICKER_CXX_TEST_MAX_LATENESS_US=... on a busy machine.
+#if !defined(TICKER_CXX_TEST_MAX_LATENESS_US)
+#define TICKER_CXX_TEST_MAX_LATENESS_US 20000
+#endif
 
 namespace {
 
   ticker::debug::X x_global_var;
 
+#if TICKER_CXX_HAS_TIMERFD
+  using fd_timer = ticker::timer_t<std::nullopt_t, ticker::Clock, false,
+                                   ticker::detail::in_job<ticker::Clock, false>,
+                                   ticker::queue::map_policy,
+                                   ticker::pool::timerfd_waiter>;
+#endif
+
   void test_timer() {
     using namespace std::literals::chrono_literals;
     ticker::debug::X const x_local_var;
@@ -54,8 +76,644 @@ namespace {
     printf("end of %s\n", __FUNCTION_NAME__);
   }
 
+  template<typename QueuePolicy>
+  void test_timer_on_wheel() {
+    using namespace std::literals::chrono_literals;
+    ticker::debug::X const x_local_var;
+
+    using wheel_timer = ticker::timer_t<std::nullopt_t, ticker::Clock, false,
+                                        ticker::detail::in_job<ticker::Clock, false>,
+                                        QueuePolicy>;
+    ticker::pool::conditional_wait_for_int count{3};
+    auto t = wheel_timer::get();
+
+    dbg_print("  - start at: %s", ticker::chrono::format_time_point().c_str());
+    for (auto d : {30ms, 10ms, 20ms}) {
+      t->after(d)
+          .on([&count, d] {
+            ticker::pool::cw_setter const cws(count);
+            printf("  - after %s [%02d]: %s\n", ticker::chrono::format_duration(d).c_str(), count.val(),
+                   ticker::chrono::format_time_point().c_str());
+          })
+          .build();
+    }
+
+    count.wait();
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+  // only the jobs of an intrusive queue carry its links
+  void test_timer_hooked_jobs() {
+    using namespace std::literals::chrono_literals;
+    using in_job = ticker::detail::in_job<ticker::Clock, false>;
+    static_assert(sizeof(ticker::hooked_job<in_job>) > sizeof(in_job));
+    ticker::scheduler<ticker::Clock, ticker::queue::wheel_policy<>> plain(1);
+    ticker::scheduler<ticker::Clock, ticker::queue::intrusive_wheel_policy<>> hooked(1);
+    if (plain.make_job<in_job>([] {})->queue_hook() || !hooked.make_job<in_job>([] {})->queue_hook()) {
+      dbg_print("ERROR: expecting the hook on the jobs of the intrusive wheel only");
+      exit(-1);
+    }
+
+    bool rejected = false;
+    try {
+      hooked.add(ticker::Clock::now() + 1ms, std::make_shared<in_job>([] {}));
+    } catch (std::invalid_argument const &) {
+      rejected = true;
+    }
+    if (!rejected || hooked.size() != 0) {
+      dbg_print("ERROR: expecting a job without the hook rejected by the intrusive wheel");
+      exit(-1);
+    }
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+  template<typename Timer>
+  void test_timer_lateness() {
+    using namespace std::literals::chrono_literals;
+    ticker::debug::X const x_local_var;
+
+    const int n = 20;
+    const auto gap = 500us;
+    const std::chrono::microseconds bound{TICKER_CXX_TEST_MAX_LATENESS_US};
+    std::vector<std::chrono::microseconds> lateness(n);
+    ticker::pool::conditional_wait_for_int count{n};
+    auto t = Timer::get();
+
+    auto start = ticker::Clock::now() + 5ms;
+    for (int i = 0; i < n; i++) {
+      auto tp = start + gap * i;
+      t->at(tp)
+          .on([&count, &lateness, tp, i] {
+            auto now = ticker::Clock::now();
+            ticker::pool::cw_setter const cws(count);
+            lateness[i] = std::chrono::duration_cast<std::chrono::microseconds>(now - tp);
+          })
+          .build();
+    }
+
+    count.wait();
+    auto worst = std::chrono::microseconds::zero();
+    for (int i = 0; i < n; i++) {
+      if (lateness[i] < std::chrono::microseconds::zero()) {
+        dbg_print("ERROR: timer #%d fired %s early", i, ticker::chrono::format_duration(-lateness[i]).c_str());
+        exit(-1);
+      }
+      if (lateness[i] > worst) worst = lateness[i];
+    }
+    printf("  - worst lateness of %d timers in %s gaps: %s (bound: %s)\n", n,
+           ticker::chrono::format_duration(gap).c_str(),
+           ticker::chrono::format_duration(worst).c_str(),
+           ticker::chrono::format_duration(bound).c_str());
+    if (worst > bound) {
+      dbg_print("ERROR: lateness %s exceeds the bound %s", ticker::chrono::format_duration(worst).c_str(), ticker::chrono::format_duration(bound).c_str());
+      exit(-1);
+    }
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+  template<typename Timer>
+  void test_timer_wakeup() {
+    using namespace std::literals::chrono_literals;
+    ticker::debug::X const x_local_var;
+
+    const std::chrono::microseconds bound{TICKER_CXX_TEST_MAX_LATENESS_US};
+    std::chrono::microseconds lateness{};
+    ticker::pool::conditional_wait_for_int count{1};
+    auto t = Timer::get();
+
+    // let the runner fall into its long idle sleep
+    std::this_thread::sleep_for(100ms);
+
+    auto tp = ticker::Clock::now() + 1ms;
+    t->at(tp)
+        .on([&count, &lateness, tp] {
+          auto now = ticker::Clock::now();
+          ticker::pool::cw_setter const cws(count);
+          lateness = std::chrono::duration_cast<std::chrono::microseconds>(now - tp);
+        })
+        .build();
+
+    count.wait();
+    printf("  - in(1ms) during an idle sleep fired %s late (bound: %s)\n",
+           ticker::chrono::format_duration(lateness).c_str(),
+           ticker::chrono::format_duration(bound).c_str());
+    if (lateness > bound) {
+      dbg_print("ERROR: the runner was not woken up for an earlier deadline");
+      exit(-1);
+    }
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+  void test_timer_release() {
+    using namespace std::literals::chrono_literals;
+    ticker::debug::X const x_local_var;
+
+    const int n = 10;
+    ticker::pool::conditional_wait_for_int count{n};
+    auto t = ticker::timer_t<>::get();
+    t->keep_history(4);
+    // the recurring jobs alongside are not kept
+    auto tk = ticker::ticker_t<>::get(t->get_scheduler());
+    tk->every(1ms).on([] {}).build();
+    tk->interval(1ms).on([] {}).build();
+
+    std::vector<std::weak_ptr<int>> sentinels;
+    for (int i = 0; i < n; i++) {
+      auto sentinel = std::make_shared<int>(i);
+      sentinels.emplace_back(sentinel);
+      t->after(1ms)
+          .on([&count, sentinel] {
+            ticker::pool::cw_setter const cws(count);
+          })
+          .build();
+    }
+    count.wait();
+    std::this_thread::sleep_for(20ms); // the ticker fires on
+
+    // the fired jobs are released once their pool tasks completed,
+    // except the ones kept in the history ring.
+    int alive{};
+    for (int retry = 0; retry < 100; retry++, std::this_thread::sleep_for(10ms)) {
+      alive = 0;
+      for (auto &w : sentinels) alive += w.expired() ? 0 : 1;
+      if (alive <= 4) break;
+    }
+    auto history = t->history();
+    printf("  - %d of %d fired jobs alive, %zu kept in history\n", alive, n, history.size());
+    if (alive != 4 || history.size() != 4 ||
+        std::any_of(history.begin(), history.end(), [](auto const &e) { return e.second->_recur || e.second->_interval; })) {
+      dbg_print("ERROR: expecting 4 one-shot jobs kept in history");
+      exit(-1);
+    }
+
+    tk->clear();
+    history.clear();
+    t->keep_history(0);
+    // the last pool task may still hold its job a moment after firing
+    for (int retry = 0; retry < 100; retry++, std::this_thread::sleep_for(1ms)) {
+      alive = (int) std::count_if(sentinels.begin(), sentinels.end(), [](auto &w) { return !w.expired(); });
+      if (alive == 0) break;
+    }
+    if (!t->history().empty() || alive != 0) {
+      dbg_print("ERROR: the history should be released");
+      exit(-1);
+    }
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+  void test_timer_cancel() {
+    using namespace std::literals::chrono_literals;
+    ticker::debug::X const x_local_var;
+
+    const int n = 10;
+    ticker::pool::conditional_wait_for_int count{n / 2};
+    std::atomic<int> mask{0};
+    auto t = ticker::timer_t<>::get();
+
+    std::vector<ticker::timer_handle> handles;
+    for (int i = 0; i < n; i++) {
+      handles.emplace_back(t->after(20ms)
+                                   .on([&count, &mask, i] {
+                                     mask |= 1 << i;
+                                     ticker::pool::cw_setter const cws(count);
+                                   })
+                                   .build());
+    }
+    for (int i = 0; i < n; i += 2) {
+      if (!handles[i].cancel() || handles[i].cancel() || handles[i].pending()) {
+        dbg_print("ERROR: handle %d cannot be cancelled exactly once", i);
+        exit(-1);
+      }
+    }
+    count.wait();
+    std::this_thread::sleep_for(20ms);
+
+    printf("  - fired mask: 0x%03x, %zu handles pending\n", mask.load(), t->pending_handles());
+    if (mask.load() != 0x2aa || t->pending_handles() != 0) {
+      dbg_print("ERROR: only the odd timers should be fired");
+      exit(-1);
+    }
+    // the fired ones are stale now
+    for (int i = 1; i < n; i += 2) {
+      if (handles[i].cancel() || handles[i].pending()) {
+        dbg_print("ERROR: handle %d should be stale after fired", i);
+        exit(-1);
+      }
+    }
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+  // cancel() against the runner firing the same one-shots: a job
+  // whose cancel() returned true never runs, the others run once
+  void test_timer_cancel_race() {
+    using namespace std::literals::chrono_literals;
+    const int rounds = 20, n = 200;
+    auto t = ticker::timer_t<>::get();
+    std::vector<std::atomic<int>> ran(std::size_t(rounds * n));
+    std::vector<char> cancelled(std::size_t(rounds * n));
+    int won = 0;
+    for (int r = 0; r < rounds; r++) {
+      std::vector<ticker::timer_handle> handles;
+      auto due = ticker::Clock::now() + 1ms;
+      for (int i = 0; i < n; i++) {
+        auto &hit = ran[std::size_t(r * n + i)];
+        handles.emplace_back(t->at(due + std::chrono::microseconds(i * 50)).on([&hit] { hit++; }).build());
+      }
+      for (int i = 0; i < n; i++) { // each one at its due time, while the runner fires it
+        std::this_thread::sleep_until(due + std::chrono::microseconds(i * 50));
+        if ((cancelled[std::size_t(r * n + i)] = handles[std::size_t(i)].cancel()) != 0) won++;
+      }
+    }
+    std::this_thread::sleep_for(50ms);
+    for (int retry = 0; retry < 200; retry++) {
+      bool all = true;
+      for (std::size_t i = 0; i < ran.size(); i++)
+        if (!cancelled[i] && ran[i].load() == 0) all = false;
+      if (all) break;
+      std::this_thread::sleep_for(10ms);
+    }
+    printf("  - %d of %d cancelled, the others fired\n", won, rounds * n);
+    for (std::size_t i = 0; i < ran.size(); i++) {
+      if (ran[i].load() != (cancelled[i] ? 0 : 1)) {
+        dbg_print("ERROR: job %zu ran %d times, cancel() returned %d", i, ran[i].load(), int(cancelled[i]));
+        exit(-1);
+      }
+    }
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+  // the threads of the front-ends attach, cancel and release at once
+  void test_job_registry() {
+    const int threads = 4, n = 3000;
+    ticker::detail::job_registry reg;
+    std::vector<std::vector<ticker::job_base>> jobs(threads);
+    std::vector<ticker::detail::job_owner> owners(threads);
+    std::vector<std::thread> ts;
+    for (int t = 0; t < threads; t++) {
+      jobs[std::size_t(t)] = std::vector<ticker::job_base>(n);
+      ts.emplace_back([&, t] {
+        auto &js = jobs[std::size_t(t)];
+        auto &owner = owners[std::size_t(t)];
+        for (int i = 0; i < n; i++) {
+          auto h = reg.attach(js[std::size_t(i)], &owner);
+          if (i % 3 == 0) h.cancel();                        // by its handle
+          if (i % 3 == 1) reg.release(js[std::size_t(i)]); // fired
+        }
+      });
+    }
+    for (auto &t : ts) t.join();
+    for (int t = 0; t < threads; t++) {
+      auto &js = jobs[std::size_t(t)];
+      auto &owner = owners[std::size_t(t)];
+      if (reg.size(owner) != std::size_t(n / 3) || reg.cancel_all(owner) != std::size_t(n / 3) || reg.size(owner) != 0) {
+        dbg_print("ERROR: expecting %d jobs of owner %d left to cancel_all()", n / 3, t);
+        exit(-1);
+      }
+      for (int i = 0; i < n; i++) {
+        if (js[std::size_t(i)].cancelled() != (i % 3 != 1)) {
+          dbg_print("ERROR: job %d of owner %d cancelled wrongly", i, t);
+          exit(-1);
+        }
+      }
+    }
+    if (reg.size() != 0) {
+      dbg_print("ERROR: expecting no handle left, got %zu", reg.size());
+      exit(-1);
+    }
+
+    // a stale handle doesn't reach the job reusing its slot
+    ticker::detail::job_registry one;
+    ticker::job_base a, b;
+    auto ha = one.attach(a);
+    ha.cancel();
+    auto hb = one.attach(b);
+    if (hb.id() != ha.id() || ha.cancel() || ha.pending() || !hb.pending() || b.cancelled()) {
+      dbg_print("ERROR: expecting the slot reused by a new generation");
+      exit(-1);
+    }
+
+    // the slot decides between cancel() and the runner firing a one-shot
+    ticker::job_base c;
+    auto hc = one.attach(c);
+    if (!hc.cancel() || one.release(c) || !one.release(b) || hb.cancel() || b.cancelled()) {
+      dbg_print("ERROR: expecting either the cancel() or the release() of a job wins, not both");
+      exit(-1);
+    }
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+  void test_timer_schedule_many() {
+    using namespace std::literals::chrono_literals;
+    ticker::debug::X const x_local_var;
+
+    const int n = 100;
+    ticker::pool::conditional_wait_for_int count{n};
+    std::mutex m;
+    std::vector<int> order;
+    auto t = ticker::timer_t<>::get();
+
+    // in the reverse order, 1ms apart
+    auto base = ticker::Clock::now() + 20ms;
+    std::vector<std::pair<ticker::Clock::time_point, std::function<void()>>> items;
+    for (int i = 0; i < n; i++) {
+      items.emplace_back(base + std::chrono::milliseconds(n - i), [&count, &m, &order, i] {
+        {
+          std::unique_lock<std::mutex> l(m);
+          order.push_back(i);
+        }
+        ticker::pool::cw_setter const cws(count);
+      });
+    }
+    auto handles = t->schedule_many(std::move(items));
+    if (handles.size() != std::size_t(n) || t->pending_handles() != std::size_t(n)) {
+      dbg_print("ERROR: expecting %d handles", n);
+      exit(-1);
+    }
+    count.wait();
+
+    // the pool may reorder the jobs picked in one wakeup, but not far apart
+    int disorder{};
+    for (std::size_t i = 1; i < order.size(); i++)
+      if (order[i] > order[i - 1]) disorder++;
+    printf("  - %zu jobs fired, %d out of order\n", order.size(), disorder);
+    if (order.size() != std::size_t(n) || disorder > n / 4) {
+      dbg_print("ERROR: the batch was not fired in time order");
+      exit(-1);
+    }
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+  void test_timer_slack() {
+    using namespace std::literals::chrono_literals;
+    ticker::debug::X const x_local_var;
+
+    // dense one-shots, 20us apart, each tolerating 5ms
+    const int n = 200;
+    const auto slack = 5ms;
+    ticker::pool::conditional_wait_for_int count{n};
+    std::atomic<int> early{0}, late{0};
+    auto t = ticker::timer_t<>::get();
+    auto base = ticker::Clock::now() + 20ms;
+    for (int i = 0; i < n; i++) {
+      auto due = base + std::chrono::microseconds(20 * i);
+      t->at(due)
+          .slack(slack)
+          .on([&count, &early, &late, due, slack] {
+            auto now = ticker::Clock::now();
+            if (now < due) early++;
+            if (now > due + slack + std::chrono::microseconds(TICKER_CXX_TEST_MAX_LATENESS_US)) late++;
+            ticker::pool::cw_setter const cws(count);
+          })
+          .build();
+    }
+    count.wait();
+
+    printf("  - %d jobs fired in %zu wakeups, %zu coalesced; %d early, %d late\n",
+           n, t->wakeups(), t->coalesced_wakeups(), early.load(), late.load());
+    if (early.load() != 0 || late.load() != 0) {
+      dbg_print("ERROR: a slacked job fired out of its window");
+      exit(-1);
+    }
+    if (t->coalesced_wakeups() == 0 || t->coalesced_wakeups() > t->wakeups() || t->wakeups() >= std::size_t(n / 4)) {
+      dbg_print("ERROR: the slacked jobs were not coalesced");
+      exit(-1);
+    }
+
+    // the window of a cancelled job neither wakes the runner nor merges
+    auto u = ticker::timer_t<>::get();
+    ticker::pool::conditional_wait_for_int one{1};
+    auto now = ticker::Clock::now();
+    auto h = u->at(now + 10ms).slack(1ms).on([] {}).build();
+    h.cancel();
+    u->at(now + 5ms).slack(20ms).on([&one] { ticker::pool::cw_setter const cws(one); }).build();
+    one.wait();
+    auto fired_at = ticker::Clock::now();
+    printf("  - fired at +%.1fms, %zu coalesced\n", std::chrono::duration<double, std::milli>(fired_at - now).count(), u->coalesced_wakeups());
+    if (u->coalesced_wakeups() != 0 || fired_at < now + 20ms) {
+      dbg_print("ERROR: expecting the cancelled window skipped, the job fired at its own deadline");
+      exit(-1);
+    }
+
+    // schedule() and schedule_many() take the slack too
+    auto w = ticker::timer_t<>::get();
+    ticker::pool::conditional_wait_for_int batch{n};
+    std::vector<std::pair<ticker::Clock::time_point, std::function<void()>>> items;
+    base = ticker::Clock::now() + 20ms;
+    for (int i = 0; i < n; i++) {
+      auto due = base + std::chrono::microseconds(20 * i);
+      auto f = [&batch, &early, due] {
+        if (ticker::Clock::now() < due) early++;
+        ticker::pool::cw_setter const cws(batch);
+      };
+      if (i % 2) items.emplace_back(due, f);
+      else w->schedule(due, f, slack);
+    }
+    w->schedule_many(std::move(items), slack);
+    batch.wait();
+    printf("  - scheduled: %d jobs fired in %zu wakeups, %zu coalesced\n", n, w->wakeups(), w->coalesced_wakeups());
+    if (early.load() != 0 || w->coalesced_wakeups() == 0 || w->wakeups() >= std::size_t(n / 4)) {
+      dbg_print("ERROR: expecting the slack of schedule() and schedule_many() coalescing the jobs");
+      exit(-1);
+    }
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+  void test_steady_timer() {
+    using namespace std::literals::chrono_literals;
+    ticker::debug::X const x_local_var;
+
+    const int n = 5;
+    ticker::pool::conditional_wait_for_int count{n};
+    std::atomic<int> early{0};
+    auto t = ticker::steady_timer::get();
+    for (int i = 0; i < n; i++) {
+      auto due = std::chrono::steady_clock::now() + std::chrono::milliseconds(5 * (i + 1));
+      t->at(due)
+          .on([&count, &early, due] {
+            if (std::chrono::steady_clock::now() < due) early++;
+            ticker::pool::cw_setter const cws(count);
+          })
+          .build();
+    }
+    count.wait();
+    printf("  - %d steady timers fired, %d early\n", n, early.load());
+    if (early.load() != 0) {
+      dbg_print("ERROR: a steady timer fired early");
+      exit(-1);
+    }
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+  // the threads of this process, -1 if unknown
+  int thread_count() {
+    int n = -1;
+#if defined(__linux__)
+    if (FILE *f = fopen("/proc/self/status", "r")) {
+      char line[256];
+      while (fgets(line, sizeof(line), f))
+        if (sscanf(line, "Threads: %d", &n) == 1) break;
+      fclose(f);
+    }
+#endif
+    return n;
+  }
+
+  void test_shared_scheduler() {
+    using namespace std::literals::chrono_literals;
+    ticker::debug::X const x_local_var;
+
+    const int n = 25;
+    // outlive the scheduler, which completes the dispatched jobs
+    ticker::pool::conditional_wait_for_int count{n};
+    std::vector<std::atomic<int>> ticks(n);
+    const int before = thread_count();
+    auto s = std::make_shared<ticker::scheduler<>>(2);
+    std::vector<std::unique_ptr<ticker::timer_t<>>> timers;
+    std::vector<std::unique_ptr<ticker::ticker_t<>>> tickers;
+    for (int i = 0; i < n; i++) {
+      timers.emplace_back(ticker::timer_t<>::get(s));
+      tickers.emplace_back(ticker::ticker_t<>::get(s));
+    }
+    const int threads = thread_count() - before;
+    printf("  - %d timers and %d tickers on %d threads\n", n, n, threads);
+    // at most, a detached runner of the tests before may just be exiting
+    if (before > 0 && threads > 3) {
+      dbg_print("ERROR: expecting a runner and 2 workers, but %d threads were started", threads);
+      exit(-1);
+    }
+
+    for (int i = 0; i < n; i++) {
+      timers[i]->after(10ms).on([&count] { ticker::pool::cw_setter const cws(count); }).build();
+      tickers[i]->every(5ms).on([&ticks, i] { ticks[i]++; }).build();
+    }
+    auto far = timers[0]->after(1h).on([] {}).build();
+    count.wait();
+    if (timers[0]->pending_handles() != 1 || tickers[0]->pending_handles() != 1) {
+      dbg_print("ERROR: the pending handles are counted per front-end");
+      exit(-1);
+    }
+
+    // the detached front-ends' jobs are cancelled, the others go on
+    timers[0].reset();
+    if (far.pending()) {
+      dbg_print("ERROR: the job of a destroyed timer is still pending");
+      exit(-1);
+    }
+    for (int i = n / 2; i < n; i++) tickers[i].reset();
+    std::this_thread::sleep_for(20ms); // let the dispatched ticks drain
+    std::vector<int> seen;
+    for (auto &it : ticks) seen.push_back(it.load());
+    std::this_thread::sleep_for(50ms);
+    for (int i = 0; i < n; i++) {
+      bool alive = i < n / 2;
+      if (alive == (ticks[i].load() == seen[i])) {
+        dbg_print("ERROR: ticker %d %s ticking after the others detached", i, alive ? "stopped" : "kept");
+        exit(-1);
+      }
+    }
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
+  // an executor of the application, which counts the jobs it runs
+  struct counting_executor {
+    ticker::pool::thread_pool pool{2};
+    std::atomic<int> posted{0};
+    template<typename F>
+    void post(F &&f) {
+      posted++;
+      pool.post(std::forward<F>(f));
+    }
+  };
+
+  // rejects every other post, as a full ring or a stopped pool does
+  struct rejecting_executor {
+    ticker::pool::thread_pool pool{1};
+    std::atomic<int> posted{0};
+    template<typename F>
+    void post(F &&f) {
+      if (posted++ % 2 == 0) throw std::runtime_error("rejected");
+      pool.post(std::forward<F>(f));
+    }
+  };
+
+  void test_timer_executor() {
+    using namespace std::literals::chrono_literals;
+    ticker::debug::X const x_local_var;
+    static_assert(ticker::pool::is_executor_v<ticker::pool::thread_pool>);
+    static_assert(ticker::pool::is_executor_v<ticker::pool::inline_executor>);
+    static_assert(!ticker::pool::is_executor_v<ticker::scheduler<>>);
+
+    const int n = 10;
+    {
+      // the inline jobs run on the runner thread, one by one
+      ticker::pool::conditional_wait_for_int count{n};
+      std::mutex m;
+      std::vector<std::thread::id> ids;
+      auto t = ticker::timer_t<>::get(std::make_shared<ticker::pool::inline_executor>());
+      for (int i = 0; i < n; i++) {
+        t->after(std::chrono::milliseconds(i)).on([&] {
+          std::unique_lock<std::mutex> l(m);
+          ids.push_back(std::this_thread::get_id());
+          ticker::pool::cw_setter const cws(count);
+        }).build();
+      }
+      count.wait();
+      std::unique_lock<std::mutex> l(m);
+      if (std::count(ids.begin(), ids.end(), ids.front()) != n || ids.front() == std::this_thread::get_id()) {
+        dbg_print("ERROR: the inline jobs should run on the runner thread");
+        exit(-1);
+      }
+    }
+    {
+      ticker::pool::conditional_wait_for_int count{n};
+      auto e = std::make_shared<counting_executor>();
+      {
+        auto t = ticker::ticker_t<>::get(e);
+        t->interval(2ms).on([&count] { ticker::pool::cw_setter const cws(count); }).build();
+        count.wait();
+      }
+      printf("  - %d jobs posted to the executor\n", e->posted.load());
+      if (e->posted.load() < n) {
+        dbg_print("ERROR: expecting the jobs run on the given executor");
+        exit(-1);
+      }
+    }
+    {
+      // a rejected job is dropped, the runner keeps on
+      std::atomic<int> ran{0};
+      auto t = ticker::timer_t<>::get(std::make_shared<rejecting_executor>());
+      for (int i = 0; i < n; i++)
+        t->after(std::chrono::milliseconds(1 + i)).on([&ran] { ran++; }).build();
+      for (int retry = 0; retry < 200 && (ran.load() < n / 2 || t->pending_handles() != 0); retry++)
+        std::this_thread::sleep_for(5ms);
+      if (ran.load() != n / 2 || t->pending_handles() != 0) {
+        dbg_print("ERROR: expecting %d jobs run and the rejected ones dropped, %d ran", n / 2, ran.load());
+        exit(-1);
+      }
+    }
+    printf("end of %s\n", __FUNCTION_NAME__);
+  }
+
 } // namespace
 
 int main() {
   TICKER_TEST_FOR(test_timer);
+  TICKER_TEST_FOR(test_timer_on_wheel<ticker::queue::wheel_policy<std::chrono::microseconds>>);
+  TICKER_TEST_FOR(test_timer_on_wheel<ticker::queue::intrusive_wheel_policy<std::chrono::microseconds>>);
+  TICKER_TEST_FOR(test_timer_hooked_jobs);
+  TICKER_TEST_FOR(test_timer_lateness<ticker::timer_t<>>);
+  TICKER_TEST_FOR(test_timer_wakeup<ticker::timer_t<>>);
+#if TICKER_CXX_HAS_TIMERFD
+  TICKER_TEST_FOR(test_timer_lateness<fd_timer>);
+  TICKER_TEST_FOR(test_timer_wakeup<fd_timer>);
+#endif
+  TICKER_TEST_FOR(test_timer_release);
+  TICKER_TEST_FOR(test_timer_cancel);
+  TICKER_TEST_FOR(test_job_registry);
+  TICKER_TEST_FOR(test_timer_cancel_race);
+  TICKER_TEST_FOR(test_timer_schedule_many);
+  TICKER_TEST_FOR(test_timer_slack);
+  TICKER_TEST_FOR(test_steady_timer);
+  TICKER_TEST_FOR(test_shared_scheduler);
+  TICKER_TEST_FOR(test_timer_executor);
 }